@@ -14,6 +14,7 @@
 #include "utils/flagSet.h"
 #include "utils/hashUtils.h"
 #include "utils/ignoreUnused.h"
+#include "utils/smallVector.h"
 namespace lib {
 using std::experimental::make_optional;
 using std::experimental::nullopt;
@@ -69,8 +70,12 @@ template <typename T>
 using ExprRefMaker = ExprRef<typename AssociatedViewType<T>::type>;
 typedef Variantised<ExprRefMaker> AnyExprRef;
 // variant for vector of exprs
+// Most member and operand lists are short, these are stored inline without a
+// separate heap allocation.
+static const size_t EXPR_REF_VEC_INLINE_CAPACITY = 8;
 template <typename InnerExprType>
-using ExprRefVec = std::vector<ExprRef<InnerExprType>>;
+using ExprRefVec =
+    SmallVector<ExprRef<InnerExprType>, EXPR_REF_VEC_INLINE_CAPACITY>;
 template <typename T>
 using ExprRefVecMaker = ExprRefVec<typename AssociatedViewType<T>::type>;
 typedef Variantised<ExprRefVecMaker> AnyExprVec;
@@ -82,6 +87,9 @@ typedef std::function<std::pair<bool, AnyExprRef>(AnyExprRef,
     FindAndReplaceFunction;
 
 struct AnyIterRef;
+// false if expr does not depend on iterator, it may then be shared rather
+// than copied when unrolling for iterator.
+bool dependsOnIterator(const void* expr, const AnyIterRef& iterator);
 template <typename Trigger, bool print = false>
 class TriggerOwner;
 
@@ -102,6 +110,11 @@ struct ViewType<std::vector<ExprRef<T>>> {
     typedef T type;
 };
 
+template <typename T, size_t InlineCapacity>
+struct ViewType<SmallVector<ExprRef<T>, InlineCapacity>> {
+    typedef T type;
+};
+
 #define viewType(t) typename ::ViewType<BaseType<decltype(t)>>::type
 
 struct PathExtension {
@@ -259,7 +272,7 @@ struct ExprInterface : public Undefinable<View> {
 
     inline ExprRef<View> deepCopyForUnroll(const ExprRef<View>& self,
                                            const AnyIterRef& iterator) {
-        if (isConstant()) {
+        if (isConstant() || !dependsOnIterator(this, iterator)) {
             return self;
         }
 
@@ -0,0 +1,75 @@
+#include "base/triggers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+using namespace std;
+
+// deferredNotifiers[level] holds the operators waiting to notify at that
+// level.
+static vector<vector<DeferredNotifier*>> deferredNotifiers;
+static size_t numberDeferred = 0;
+static bool flushing = false;
+static UInt flushingLevel = 0;
+
+static void removeFromLevel(DeferredNotifier& notifier) {
+    auto& notifiers = deferredNotifiers[notifier.level];
+    auto iter = find(notifiers.begin(), notifiers.end(), &notifier);
+    debug_code(assert(iter != notifiers.end()));
+    notifiers.erase(iter);
+    --numberDeferred;
+}
+
+DeferredNotifier::~DeferredNotifier() {
+    if (notificationPending) {
+        removeFromLevel(*this);
+    }
+}
+
+void deferNotification(DeferredNotifier& notifier) {
+    if (!TriggerDepthTracker::insideTriggers()) {
+        // nothing to batch with, notify straight away
+        notifier.flushNotification();
+        return;
+    }
+    bool mustRaiseLevel = flushing && notifier.level <= flushingLevel;
+    if (notifier.notificationPending) {
+        if (!mustRaiseLevel) {
+            return;
+        }
+        removeFromLevel(notifier);
+    }
+    if (mustRaiseLevel) {
+        notifier.level = flushingLevel + 1;
+    }
+    if (notifier.level >= deferredNotifiers.size()) {
+        deferredNotifiers.resize(notifier.level + 1);
+    }
+    deferredNotifiers[notifier.level].push_back(&notifier);
+    notifier.notificationPending = true;
+    ++numberDeferred;
+}
+
+bool flushDeferredNotifications() {
+    // notifying parents visits triggers, which flush again once they reach
+    // the bottom.  Notifiers deferred by then are left to the outer flush.
+    if (flushing || numberDeferred == 0) {
+        return false;
+    }
+    flushing = true;
+    for (size_t level = 0; level < deferredNotifiers.size(); level++) {
+        flushingLevel = level;
+        // flushing may defer further notifiers, always at a higher level
+        while (!deferredNotifiers[level].empty()) {
+            DeferredNotifier* notifier = deferredNotifiers[level].back();
+            deferredNotifiers[level].pop_back();
+            --numberDeferred;
+            notifier->notificationPending = false;
+            notifier->flushNotification();
+        }
+    }
+    flushing = false;
+    debug_code(assert(numberDeferred == 0));
+    return true;
+}
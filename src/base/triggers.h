@@ -2,6 +2,7 @@
 #ifndef SRC_BASE_TRIGGERS_H_
 #define SRC_BASE_TRIGGERS_H_
 #include <memory>
+#include <vector>
 
 #include "base/exprRef.h"
 #include "base/typeDecls.h"
@@ -30,11 +31,19 @@ static const size_t MIN_CLEAN_SIZE = 16;
 template <typename T>
 class TriggerQueue;
 
+// Every value node (including each member of a sequence or matrix of ints)
+// owns at least one trigger queue, most of which stay empty for the entire
+// search.  A vector does not allocate until the first trigger is added,
+// whereas a deque allocates its map and first block on construction, which
+// made empty queues the dominant per element memory cost of large int
+// containers.  Adding a trigger may reallocate the vector, so visitTriggers
+// holds its own copy of each trigger it visits rather than a reference into
+// the queue.
 template <typename T>
 class TriggerQueue {
     bool currentlyProcessing = false;
     size_t lastCleanSize = 0;
-    std::deque<std::shared_ptr<T>> triggers;
+    std::vector<std::shared_ptr<T>> triggers;
 
    public:
     struct QueueAccess {
@@ -45,7 +54,7 @@ class TriggerQueue {
         bool firstAccess;
 
        public:
-        std::deque<std::shared_ptr<T>>& triggers;
+        std::vector<std::shared_ptr<T>>& triggers;
 
        private:
         QueueAccess(TriggerQueue<T>& queue)
@@ -70,6 +79,17 @@ class TriggerQueue {
                         other.triggers.end());
         other.triggers.clear();
     }
+    // the number of triggers that have not been deleted.
+    size_t numberActive() const {
+        size_t count = 0;
+        for (auto& trigger : triggers) {
+            if (trigger && trigger->active()) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
     template <typename Trigger>
     void add(Trigger&& trigger) {
         if (!currentlyProcessing &&
@@ -134,9 +154,50 @@ class TriggerDepthTracker {
     ~TriggerDepthTracker() { --globalDepth; }
     inline int depth() { return globalDepth; }
     inline bool atBottom() { return depth() == 0; }
+    static inline bool insideTriggers() { return globalDepth >= 0; }
 };
 
+/* Operators folding many operands (OpSum, OpAnd) can receive several child
+ * events from a single change, for example when a neighbourhood changes
+ * several members at once.  Rather than notifying their parents after each
+ * event, such operators update their value immediately but defer the
+ * notification.  Deferred operators are bucketed by level and flushed once the
+ * outer most visitTriggers call has finished, lowest level first.  An operator
+ * that is deferred whilst another operator at the same or a higher level is
+ * being flushed must be its ancestor, so its level is raised above the one
+ * being flushed.  The levels therefore settle into a topological order of the
+ * deferring operators, after which each notifies its parents at most once per
+ * change.*/
+struct DeferredNotifier;
+void deferNotification(DeferredNotifier& notifier);
+struct DeferredNotifier {
+    UInt level = 0;
+    bool notificationPending = false;
+
+    DeferredNotifier() = default;
+    DeferredNotifier(const DeferredNotifier& other) : level(other.level) {}
+    DeferredNotifier& operator=(const DeferredNotifier&) { return *this; }
+    virtual ~DeferredNotifier();
+    virtual void flushNotification() = 0;
+    // like changeValue, but parents are notified once the current propagation
+    // has finished.
+    template <typename Func>
+    inline void changeValueDeferred(Func&& func) {
+        if (func()) {
+            deferNotification(*this);
+        }
+    }
+};
+// returns true if any deferred notifications were flushed.
+bool flushDeferredNotifications();
 void handleDefinedVarTriggers();
+// flushing deferred notifications may queue defined var triggers and vice
+// versa, so alternate until neither has any work left.
+inline void handleTriggersAfterPropagation() {
+    do {
+        handleDefinedVarTriggers();
+    } while (flushDeferredNotifications());
+}
 template <typename Visitor, typename Trigger>
 void visitTriggers(Visitor&& func, TriggerQueue<Trigger>& queue) {
     TriggerDepthTracker triggerDepth;
@@ -146,13 +207,13 @@ void visitTriggers(Visitor&& func, TriggerQueue<Trigger>& queue) {
     size_t triggerNullCount = 0;
     // triggers may be changed, insure that new triggers are ignored
     for (size_t i = 0; i < size && i < access.triggers.size(); i++) {
-        auto& trigger = access.triggers[i];
+        auto trigger = access.triggers[i];
         if (trigger && trigger->active()) {
             ++triggerEventCount;
             func(trigger);
         } else {
             ++triggerNullCount;
-            trigger = nullptr;
+            access.triggers[i] = nullptr;
         }
     }
     if (access.triggers.size() > MIN_CLEAN_SIZE &&
@@ -161,7 +222,7 @@ void visitTriggers(Visitor&& func, TriggerQueue<Trigger>& queue) {
     }
     if (triggerDepth.atBottom()) {
         // outer most visit triggers call
-        handleDefinedVarTriggers();
+        handleTriggersAfterPropagation();
     }
 }
 
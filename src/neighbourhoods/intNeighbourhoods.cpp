@@ -9,19 +9,14 @@
 using namespace std;
 Int getRandomValueInDomain(const IntDomain& domain);
 Int getRandomValueInDomain(const IntDomain& domain) {
+    if (domain.bounds.empty()) {
+        myCerr << "Error: empty  domain.\n";
+        signalEndOfSearch();
+        abort();  // put here just to stop warning
+    }
     UInt randomDomainIndex =
         globalRandom<decltype(domain.domainSize)>(0, domain.domainSize - 1);
-    for (auto& bound : domain.bounds) {
-        UInt boundSize = (bound.second - bound.first) + 1;
-        if (boundSize > randomDomainIndex) {
-            return bound.first + randomDomainIndex;
-        } else {
-            randomDomainIndex -= boundSize;
-        }
-    }
-    myCerr << "Error: empty  domain.\n";
-    signalEndOfSearch();
-    abort();  // put here just to stop warning
+    return domain.valueAtIndex(randomDomainIndex);
 }
 
 Int chooseBound(const pair<Int, Int>& bound1, const pair<Int, Int>& bound2,
@@ -50,17 +45,14 @@ Int getRandomValueInDomain(const IntDomain& domain, Int minValue,
     // check that number is in domain
     // if not choose upper of previous bound, lower of next, which ever is
     // closer.
-    // binary search is likely most efficient here, just using simpler
-    // loop for now
-    for (size_t i = 0; i < domain.bounds.size(); i++) {
-        auto& bound = domain.bounds[i];
-        if (bound.first <= newValue && newValue <= bound.second) {
-            return newValue;
-        }
-        if (i + 1 < domain.bounds.size() &&
-            newValue < domain.bounds[i + 1].first) {
-            return chooseBound(bound, domain.bounds[i + 1], newValue);
-        }
+    auto containingBound = domain.findContainingBound(newValue);
+    if (lib::get_if<IntDomain::FoundBound>(&containingBound)) {
+        return newValue;
+    }
+    auto betweenTest = lib::get_if<IntDomain::BetweenBounds>(&containingBound);
+    if (betweenTest) {
+        return chooseBound(domain.bounds[betweenTest->lower],
+                           domain.bounds[betweenTest->upper], newValue);
     }
     cout << domain << endl;
     cout << minValue << endl;
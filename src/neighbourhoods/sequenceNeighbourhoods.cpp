@@ -77,11 +77,9 @@ void sequenceLiftSingleGenImpl(const SequenceDomain& domain,
                     params.vioContainer.childViolations(val.id);
                 UInt indexToChange = vioContainerAtThisLevel.selectRandomVar(
                     val.numberElements() - 1);
-                HashType previousSubsequenceHash;
                 std::vector<HashType> subsequenceHashes;
-                previousSubsequenceHash =
-                    val.notifyPossibleSubsequenceChange<InnerValueType>(
-                        indexToChange, indexToChange + 1, subsequenceHashes);
+                val.notifyPossibleSubsequenceChange<InnerValueType>(
+                    indexToChange, indexToChange + 1, subsequenceHashes);
                 ParentCheckCallBack parentCheck =
                     [&](const AnyValVec& newValue) {
                         if (val.injective) {
@@ -94,17 +92,15 @@ void sequenceLiftSingleGenImpl(const SequenceDomain& domain,
                         }
                         return val.trySubsequenceChange<InnerValueType>(
                             indexToChange, indexToChange + 1, subsequenceHashes,
-                            previousSubsequenceHash,
                             [&]() { return params.parentCheck(params.vals); });
                     };
                 bool requiresRevert = false;
                 AcceptanceCallBack changeAccepted = [&]() {
                     requiresRevert = !params.changeAccepted();
                     if (requiresRevert) {
-                        previousSubsequenceHash =
-                            val.notifyPossibleSubsequenceChange<InnerValueType>(
-                                indexToChange, indexToChange + 1,
-                                subsequenceHashes);
+                        val.notifyPossibleSubsequenceChange<InnerValueType>(
+                            indexToChange, indexToChange + 1,
+                            subsequenceHashes);
                     }
                     return !requiresRevert;
                 };
@@ -125,7 +121,7 @@ void sequenceLiftSingleGenImpl(const SequenceDomain& domain,
                 if (requiresRevert) {
                     val.trySubsequenceChange<InnerValueType>(
                         indexToChange, indexToChange + 1, subsequenceHashes,
-                        previousSubsequenceHash, [&]() { return true; });
+                        [&]() { return true; });
                 }
             });
     }
@@ -386,9 +382,8 @@ struct SequenceRelaxSub
             endIndex =
                 min<UInt>(startIndex + *subsetSize, val.numberElements());
             oldHashes.clear();
-            HashType previousSubseqHash =
-                val.notifyPossibleSubsequenceChange<InnerValueType>(
-                    startIndex, endIndex, oldHashes);
+            val.notifyPossibleSubsequenceChange<InnerValueType>(
+                startIndex, endIndex, oldHashes);
             insureSize(innerDomain, newValues, endIndex - startIndex);
 
             success = assignNewValues(innerDomain, val, oldHashes, newValues,
@@ -402,7 +397,7 @@ struct SequenceRelaxSub
             swapSub(members, newValues, startIndex, endIndex);
 
             success = val.trySubsequenceChange<InnerValueType>(
-                startIndex, endIndex, oldHashes, previousSubseqHash, [&]() {
+                startIndex, endIndex, oldHashes, [&]() {
                     // swap it back
                     swapSub(members, newValues, startIndex, endIndex);
                     if (params.parentCheck(params.vals)) {
@@ -428,13 +423,11 @@ struct SequenceRelaxSub
         if (!params.changeAccepted()) {
             debug_neighbourhood_action("Change rejected");
             oldHashes.clear();
-            HashType previousSubseqHash =
-                val.notifyPossibleSubsequenceChange<InnerValueType>(
-                    startIndex, endIndex, oldHashes);
+            val.notifyPossibleSubsequenceChange<InnerValueType>(
+                startIndex, endIndex, oldHashes);
             swapAssignedValuesOfSub(members, newValues, startIndex, endIndex);
             val.trySubsequenceChange<InnerValueType>(
-                startIndex, endIndex, oldHashes, previousSubseqHash,
-                []() { return true; });
+                startIndex, endIndex, oldHashes, []() { return true; });
         }
     }
 };
@@ -697,19 +690,16 @@ struct SequenceCrossover
                                  Func&& parentCheck) {
         fromValMemberHashes.clear();
         toValMemberHashes.clear();
-        HashType fromValSubseqHash =
-            fromVal.notifyPossibleSubsequenceChange<InnerValueType>(
-                indexToCrossOver, indexToCrossOver + 1, fromValMemberHashes);
-        HashType toValSubseqHash =
-            toVal.notifyPossibleSubsequenceChange<InnerValueType>(
-                indexToCrossOver, indexToCrossOver + 1, toValMemberHashes);
+        fromVal.notifyPossibleSubsequenceChange<InnerValueType>(
+            indexToCrossOver, indexToCrossOver + 1, fromValMemberHashes);
+        toVal.notifyPossibleSubsequenceChange<InnerValueType>(
+            indexToCrossOver, indexToCrossOver + 1, toValMemberHashes);
         swapValAssignments(*member1, *member2);
         bool success = fromVal.trySubsequenceChange<InnerValueType>(
-            indexToCrossOver, indexToCrossOver + 1, fromValMemberHashes,
-            fromValSubseqHash, [&]() {
+            indexToCrossOver, indexToCrossOver + 1, fromValMemberHashes, [&]() {
                 return toVal.trySubsequenceChange<InnerValueType>(
                     indexToCrossOver, indexToCrossOver + 1, toValMemberHashes,
-                    toValSubseqHash, [&]() {
+                    [&]() {
                         if (parentCheck()) {
                             return true;
                         } else {
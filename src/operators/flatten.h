@@ -18,8 +18,10 @@ bool replaceIfOperandIsSameAsOp(Op& op, ExprRefVec<View>& members,
                       << op.getOpName());
             members[index] = std::move(members.back());
             members.pop_back();
+            // copied rather than moved, the operand may be shared with
+            // other parents.
             for (auto& operandMember : operandMembers) {
-                members.emplace_back(std::move(operandMember));
+                members.emplace_back(operandMember);
             }
             return true;
         }
@@ -0,0 +1,75 @@
+
+#ifndef SRC_OPERATORS_FOLDINGOPERATOR_H_
+#define SRC_OPERATORS_FOLDINGOPERATOR_H_
+#include <utility>
+
+#include "operators/previousValueCache.h"
+#include "operators/quantifier.h"
+#include "operators/simpleOperator.h"
+#include "types/sequence.h"
+
+// base of the operators that fold the members of a sequence into a single
+// value, one Int per member.  The value folded in for each member is cached
+// so that it can be taken back out when the member changes.  If the optimiser
+// sets fuseWithOperand, the operand is a quantifier and, once triggering, the
+// quantifier caches the folded values instead (see FoldingParent), in which
+// case fusedOperand points to it.  Derived supplies the fold arithmetic, that
+// is foldValueOf and unrolledExprChanged.
+template <typename View, typename Derived>
+struct FoldingOperator : public SimpleUnaryOperator<View, SequenceView, Derived>,
+                         public DeferredNotifier,
+                         public FoldingParent {
+    typedef SimpleUnaryOperator<View, SequenceView, Derived> SimpleSuper;
+    using SimpleSuper::SimpleSuper;
+    bool fuseWithOperand = false;
+    QuantifierBase* fusedOperand = nullptr;
+    PreviousValueCache<Int> cachedValues;
+    ~FoldingOperator();
+
+    inline Int& cachedValue(UInt index) {
+        return (fusedOperand) ? fusedOperand->foldedValue(index)
+                              : cachedValues.get(index);
+    }
+    inline Int cachedValue(UInt index) const {
+        return (fusedOperand) ? fusedOperand->foldedValue(index)
+                              : cachedValues.get(index);
+    }
+    inline Int exchangeCachedValue(UInt index, Int newValue) {
+        return std::exchange(cachedValue(index), newValue);
+    }
+    // when fused, the quantifier has already folded in the new member.
+    inline void insertCachedValue(UInt index, Int value) {
+        if (!fusedOperand) {
+            cachedValues.insert(index, value);
+        }
+    }
+    inline Int eraseCachedValue(UInt index) {
+        return (fusedOperand) ? fusedOperand->foldedValue(index)
+                              : cachedValues.erase(index);
+    }
+    inline void swapCachedValues(UInt index1, UInt index2) {
+        if (!fusedOperand) {
+            cachedValues.swap(index1, index2);
+        }
+    }
+    // for use whilst reevaluating, after cachedValues has been cleared and
+    // for each index in order.
+    inline void recacheValue(UInt index, Int value) {
+        if (fusedOperand) {
+            fusedOperand->foldedValue(index) = value;
+        } else {
+            cachedValues.insert(index, value);
+        }
+    }
+
+    void startTriggeringImpl() final;
+    void stopTriggering() final;
+    void unfused(UInt numberFolded) final;
+    void flushNotification() final;
+    // after optimising, newOp may or may not share its operand with this op,
+    // so both are marked for fusion according to their own operand.
+    void markFusion(Derived& newOp);
+    void sanityCheckCachedValues(UInt numberMembers) const;
+};
+
+#endif /* SRC_OPERATORS_FOLDINGOPERATOR_H_ */
@@ -0,0 +1,63 @@
+#ifndef SRC_OPERATORS_FOLDINGOPERATOR_HPP_
+#define SRC_OPERATORS_FOLDINGOPERATOR_HPP_
+#include "operators/foldingOperator.h"
+#include "operators/simpleOperator.hpp"
+
+template <typename View, typename Derived>
+FoldingOperator<View, Derived>::~FoldingOperator() {
+    if (fusedOperand && fusedOperand->foldingParent == this) {
+        fusedOperand->foldingParent = nullptr;
+    }
+}
+
+template <typename View, typename Derived>
+void FoldingOperator<View, Derived>::startTriggeringImpl() {
+    bool firstStart = !this->operandTrigger;
+    SimpleSuper::startTriggeringImpl();
+    if (firstStart && fuseWithOperand) {
+        auto& quantifier = *getAs<QuantifierBase>(this->operand);
+        if (quantifier.fuseWith(*this)) {
+            fusedOperand = &quantifier;
+            cachedValues.clear();
+        }
+    }
+}
+
+template <typename View, typename Derived>
+void FoldingOperator<View, Derived>::stopTriggering() {
+    if (fusedOperand) {
+        fusedOperand->unfuse(*this);
+    }
+    SimpleSuper::stopTriggering();
+}
+
+template <typename View, typename Derived>
+void FoldingOperator<View, Derived>::unfused(UInt numberFolded) {
+    cachedValues.clear();
+    for (size_t i = 0; i < numberFolded; i++) {
+        cachedValues.insert(i, fusedOperand->foldedValue(i));
+    }
+    fusedOperand = nullptr;
+}
+
+template <typename View, typename Derived>
+void FoldingOperator<View, Derived>::flushNotification() {
+    if (this->isDefined()) {
+        this->notifyEntireValueChanged();
+    }
+}
+
+template <typename View, typename Derived>
+void FoldingOperator<View, Derived>::markFusion(Derived& newOp) {
+    newOp.fuseWithOperand = getAs<QuantifierBase>(newOp.operand).hasValue();
+    fuseWithOperand = getAs<QuantifierBase>(this->operand).hasValue();
+}
+
+template <typename View, typename Derived>
+void FoldingOperator<View, Derived>::sanityCheckCachedValues(
+    UInt numberMembers) const {
+    if (!fusedOperand) {
+        sanityEqualsCheck(numberMembers, cachedValues.size());
+    }
+}
+#endif /* SRC_OPERATORS_FOLDINGOPERATOR_HPP_ */
@@ -109,6 +109,16 @@ ExprRef<View> Iterator<View>::deepCopyForUnrollImpl(
         return self;
     }
 }
+
+bool dependsOnIterator(const void* expr, const AnyIterRef& iterator) {
+    return lib::visit(
+        [&](auto& iterator) {
+            return !iterator->unrollDependents ||
+                   iterator->unrollDependents->count(expr);
+        },
+        iterator.asVariant());
+}
+
 template <typename View>
 std::ostream& Iterator<View>::dumpState(std::ostream& os) const {
     os << "iter(";
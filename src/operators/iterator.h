@@ -11,6 +11,10 @@ struct Iterator : public ExprInterface<T>, public TriggerContainer<T> {
     UInt64 id;
     ExprRef<View> ref;
     std::shared_ptr<RefTrigger> refTrigger;
+    // when unrolling for this iterator, the nodes of the quantifier's
+    // templates that depend on it.  Only these are copied, the others are
+    // shared by every unrolled copy.  Null if every node is to be copied.
+    const HashSet<const void*>* unrollDependents = nullptr;
     Iterator(UInt64 id, ExprRef<View> ref) : id(id), ref(std::move(ref)) {}
     void reattachRefTrigger();
 
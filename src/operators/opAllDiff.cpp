@@ -6,6 +6,8 @@
 
 #include "operators/shiftViolatingIndices.h"
 #include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "types/sequenceVal.h"
 #include "utils/ignoreUnused.h"
 using namespace std;
 using OperandsSequenceTrigger =
@@ -51,7 +53,33 @@ class OperatorTrates<OpAllDiff>::OperandsSequenceTrigger
             },
             expr);
     }
+    void denseValueAdded(UInt index, const AnyExprRef& exprIn) {
+        op->memberValues.insert(op->memberValues.begin() + index, 0);
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        auto view = lib::get<ExprRef<IntView>>(exprIn)->getViewIfDefined();
+        if (!view) {
+            memberHasBecomeUndefined(index);
+            return;
+        }
+        if (!op->denseCanHold((*view).value)) {
+            op->leaveDenseMode();
+            return;
+        }
+        if (op->addValue((*view).value, index) > 1) {
+            op->changeValue([&]() {
+                ++op->violation;
+                return true;
+            });
+        }
+    }
+
     void valueAdded(UInt index, const AnyExprRef& exprIn) final {
+        if (op->dense) {
+            denseValueAdded(index, exprIn);
+            return;
+        }
         shiftIndices(index, true);
         shiftIndicesUp(index, op->operand->view()->numberElements(),
                        op->violatingOperands);
@@ -70,7 +98,26 @@ class OperatorTrates<OpAllDiff>::OperandsSequenceTrigger
         debug_code(op->assertValidState());
     }
 
+    void denseValueRemoved(UInt index) {
+        if (!op->allOperandsAreDefined()) {
+            if (op->operand->view()->numberUndefined == 0) {
+                op->reevaluateDefinedAndTrigger();
+                return;
+            }
+        } else if (op->removeValue(op->memberValues[index]) >= 1) {
+            op->changeValue([&]() {
+                --op->violation;
+                return true;
+            });
+        }
+        op->memberValues.erase(op->memberValues.begin() + index);
+    }
+
     void valueRemoved(UInt index, const AnyExprRef& exprIn) final {
+        if (op->dense) {
+            denseValueRemoved(index);
+            return;
+        }
         if (appearsDefined(exprIn)) {
             if (op->removeHash(op->indicesHashMap[index], index) >= 1) {
                 op->changeValue([&]() {
@@ -90,6 +137,10 @@ class OperatorTrates<OpAllDiff>::OperandsSequenceTrigger
     }
 
     inline void positionsSwapped(UInt index1, UInt index2) {
+        if (op->dense) {
+            swap(op->memberValues[index1], op->memberValues[index2]);
+            return;
+        }
         if (op->violatingOperands.count(index1)) {
             if (!op->violatingOperands.count(index2)) {
                 op->violatingOperands.erase(index1);
@@ -117,10 +168,44 @@ class OperatorTrates<OpAllDiff>::OperandsSequenceTrigger
     void memberReplaced(UInt index, const AnyExprRef&) final {
         subsequenceChanged(index, index + 1);
     }
+    void denseSubsequenceChanged(UInt startIndex, UInt endIndex) {
+        auto& members = op->operand->view()->getMembers<IntView>();
+        Int violationDelta = 0;
+        for (size_t i = startIndex; i < endIndex; i++) {
+            auto memberView = members[i]->getViewIfDefined();
+            if (!memberView) {
+                // value has become undefined, that trigger will eventually
+                // reach this op
+                break;
+            }
+            Int newValue = (*memberView).value;
+            if (!op->denseCanHold(newValue)) {
+                op->leaveDenseMode();
+                return;
+            }
+            if (op->removeValue(op->memberValues[i]) >= 1) {
+                --violationDelta;
+            }
+            if (op->addValue(newValue, i) > 1) {
+                ++violationDelta;
+            }
+        }
+        if (violationDelta != 0) {
+            op->changeValue([&]() {
+                op->violation += violationDelta;
+                return true;
+            });
+        }
+    }
+
     inline void subsequenceChanged(UInt startIndex, UInt endIndex) final {
         if (!op->allOperandsAreDefined()) {
             return;
         }
+        if (op->dense) {
+            denseSubsequenceChanged(startIndex, endIndex);
+            return;
+        }
         Int violationDelta = 0;
         bool foundUndefined = false;
         lib::visit(
@@ -176,20 +261,54 @@ class OperatorTrates<OpAllDiff>::OperandsSequenceTrigger
     }
     void memberHasBecomeDefined(UInt) final {
         if (op->operand->view()->numberUndefined == 0) {
-            op->reevaluate();
             op->reevaluateDefinedAndTrigger();
         }
     }
 };
 
+void OpAllDiff::leaveDenseMode() {
+    dense = false;
+    valueCounts.clear();
+    memberValues.clear();
+    changeValue([&]() {
+        reevaluate();
+        return true;
+    });
+}
+
+void OpAllDiff::reevaluateDense(ExprRefVec<IntView>& members) {
+    fill(valueCounts.begin(), valueCounts.end(), 0);
+    memberValues.assign(members.size(), 0);
+    for (size_t i = 0; i < members.size(); i++) {
+        Int value = members[i]->view()->value;
+        if (!denseCanHold(value)) {
+            dense = false;
+            valueCounts.clear();
+            memberValues.clear();
+            violation = 0;
+            return;
+        }
+        if (addValue(value, i) > 1) {
+            ++violation;
+        }
+    }
+}
+
 void OpAllDiff::reevaluateImpl(SequenceView& operandView) {
     if (operandView.numberUndefined > 0) {
         setDefined(false);
         return;
     }
     violation = 0;
+    if (dense) {
+        reevaluateDense(operandView.getMembers<IntView>());
+        if (dense) {
+            return;
+        }
+    }
     hashIndicesMap.clear();
     indicesHashMap.clear();
+    violatingOperands.clear();
     lib::visit(
         [&](auto& members) {
             indicesHashMap.resize(members.size());
@@ -224,6 +343,18 @@ void OpAllDiff::updateVarViolationsImpl(const ViolationContext& vioContext,
                 }
                 return;
             }
+            if (dense) {
+                // no index sets are kept, the members holding repeated
+                // values are found by a scan.
+                for (size_t index = 0; index < members.size(); index++) {
+                    UInt count = countOf(memberValues[index]);
+                    if (count > 1) {
+                        members[index]->updateVarViolations(count,
+                                                            vioContainer);
+                    }
+                }
+                return;
+            }
             for (size_t index : violatingOperands) {
                 members[index]->updateVarViolations(
                     hashIndicesMap[indicesHashMap[index]].size(), vioContainer);
@@ -232,10 +363,16 @@ void OpAllDiff::updateVarViolationsImpl(const ViolationContext& vioContext,
         operand->view()->members);
 }
 
-void OpAllDiff::copy(OpAllDiff&) const {}
+void OpAllDiff::copy(OpAllDiff& newOp) const {
+    newOp.dense = dense;
+}
 
 std::ostream& OpAllDiff::dumpState(std::ostream& os) const {
-    os << "OpAllDiff: violation=" << violation << endl;
+    os << "OpAllDiff: violation=" << violation << ", dense=" << dense << endl;
+    if (dense) {
+        os << "Member values: " << memberValues << endl;
+        return operand->dumpState(os) << ")";
+    }
     vector<UInt> sortedViolatingOperands(violatingOperands.begin(),
                                          violatingOperands.end());
     sort(sortedViolatingOperands.begin(), sortedViolatingOperands.end());
@@ -317,6 +454,31 @@ template struct SimpleUnaryOperator<BoolView, SequenceView, OpAllDiff>;
 
 string OpAllDiff::getOpName() const { return "OpAllDiff"; }
 
+void OpAllDiff::denseSanityCheck(SequenceView& operandView) const {
+    auto& members = operandView.getMembers<IntView>();
+    sanityEqualsCheck(members.size(), memberValues.size());
+    HashMap<Int, UInt> checkCounts;
+    for (size_t i = 0; i < members.size(); i++) {
+        Int value = members[i]->view()->value;
+        sanityEqualsCheck(value, memberValues[i]);
+        ++checkCounts[value];
+    }
+    UInt calcViolation = 0;
+    for (size_t offset = 0; offset < valueCounts.size(); offset++) {
+        Int value = denseLowerBound + offset;
+        auto iter = checkCounts.find(value);
+        UInt checkCount = (iter == checkCounts.end()) ? 0 : iter->second;
+        sanityEqualsCheck(checkCount, valueCounts[offset]);
+        if (checkCount > 0) {
+            calcViolation += checkCount - 1;
+            checkCounts.erase(iter);
+        }
+    }
+    sanityCheck(checkCounts.empty(),
+                "members hold values outside of the dense range.");
+    sanityEqualsCheck(calcViolation, violation);
+}
+
 void OpAllDiff::debugSanityCheckImpl() const {
     operand->debugSanityCheck();
     auto operandView = operand->getViewIfDefined();
@@ -324,6 +486,10 @@ void OpAllDiff::debugSanityCheckImpl() const {
         sanityLargeViolationCheck(violation);
         return;
     }
+    if (dense) {
+        denseSanityCheck(*operandView);
+        return;
+    }
     sanityCheck(
         operandView->numberElements() == indicesHashMap.size(),
         toString("operand has ", operandView->numberElements(),
@@ -392,9 +558,22 @@ struct OpMaker;
 
 template <>
 struct OpMaker<OpAllDiff> {
-    static ExprRef<BoolView> make(ExprRef<SequenceView>);
+    static ExprRef<BoolView> make(
+        ExprRef<SequenceView>,
+        const shared_ptr<SequenceDomain>& operandDomain = nullptr);
 };
 
-ExprRef<BoolView> OpMaker<OpAllDiff>::make(ExprRef<SequenceView> o) {
-    return make_shared<OpAllDiff>(move(o));
+ExprRef<BoolView> OpMaker<OpAllDiff>::make(
+    ExprRef<SequenceView> o, const shared_ptr<SequenceDomain>& operandDomain) {
+    auto op = make_shared<OpAllDiff>(move(o));
+    auto intDomainTest =
+        (operandDomain)
+            ? lib::get_if<shared_ptr<IntDomain>>(&operandDomain->inner)
+            : nullptr;
+    if (intDomainTest && !(*intDomainTest)->bounds.empty()) {
+        auto& bounds = (*intDomainTest)->bounds;
+        UInt range = (bounds.back().second - bounds.front().first) + 1;
+        op->dense = range < OpAllDiff::MAX_DENSE_RANGE;
+    }
+    return op;
 }
@@ -1,6 +1,7 @@
 
 #ifndef SRC_OPERATORS_OPALLDIFF_H_
 #define SRC_OPERATORS_OPALLDIFF_H_
+#include <algorithm>
 #include <vector>
 
 #include "operators/simpleOperator.h"
@@ -26,6 +27,20 @@ struct OpAllDiff
     std::vector<HashType> indicesHashMap;
     FastIterableIntSet violatingOperands;
 
+    // dense mode, chosen by the maker when the operand holds ints from a
+    // small domain.  Instead of hashing, members are counted by value in
+    // valueCounts, indexed by value - denseLowerBound.  valueCounts only
+    // covers the values the members have held, it starts empty and grows as
+    // values fall outside of it.  Once it would exceed DENSE_RANGE_PER_MEMBER
+    // times the number of members, or MAX_DENSE_RANGE, the op falls back to
+    // hashing.
+    static constexpr UInt MAX_DENSE_RANGE = 1 << 16;
+    static constexpr UInt DENSE_RANGE_PER_MEMBER = 64;
+    bool dense = false;
+    Int denseLowerBound = 0;
+    std::vector<UInt> valueCounts;
+    std::vector<Int> memberValues;
+
     OpAllDiff(OpAllDiff&&) = delete;
     OpAllDiff(const OpAllDiff&) = delete;
     size_t addHash(HashType hash, size_t memberIndex) {
@@ -60,13 +75,49 @@ struct OpAllDiff
             return indices.size();
         }
     }
+    inline bool denseCanHold(Int value) const {
+        if (valueCounts.empty()) {
+            return true;
+        }
+        Int lower = std::min(value, denseLowerBound);
+        Int upper = std::max<Int>(value, denseLowerBound + valueCounts.size());
+        UInt maxRange = std::min<UInt>(
+            MAX_DENSE_RANGE,
+            DENSE_RANGE_PER_MEMBER * std::max<size_t>(memberValues.size(), 1));
+        return UInt(upper - lower) < maxRange;
+    }
+
+    inline UInt& countOf(Int value) {
+        if (valueCounts.empty()) {
+            denseLowerBound = value;
+        } else if (value < denseLowerBound) {
+            valueCounts.insert(valueCounts.begin(), denseLowerBound - value, 0);
+            denseLowerBound = value;
+        }
+        size_t offset = value - denseLowerBound;
+        if (offset >= valueCounts.size()) {
+            valueCounts.resize(offset + 1, 0);
+        }
+        return valueCounts[offset];
+    }
+
+    // dense equivalents of addHash and removeHash
+    size_t addValue(Int value, size_t memberIndex) {
+        memberValues[memberIndex] = value;
+        return ++countOf(value);
+    }
+    size_t removeValue(Int value) { return --countOf(value); }
+    void leaveDenseMode();
+
     void reevaluateImpl(SequenceView& operandView);
+    void reevaluateDense(ExprRefVec<IntView>& members);
     void updateVarViolationsImpl(const ViolationContext& vioContext,
                                  ViolationContainer& vioContainer) final;
     void copy(OpAllDiff& newOp) const;
     std::ostream& dumpState(std::ostream& os) const final;
 
     void assertValidState();
+    void denseSanityCheck(SequenceView& operandView) const;
     std::string getOpName() const final;
     void debugSanityCheckImpl() const final;
 };
@@ -5,8 +5,8 @@
 #include <unordered_map>
 
 #include "operators/flatten.h"
-#include "operators/previousValueCache.h"
-#include "operators/simpleOperator.hpp"
+#include "operators/foldingOperator.hpp"
+#include "operators/opGcc.h"
 #include "types/boolVal.h"
 #include "types/sequenceVal.h"
 #include "utils/ignoreUnused.h"
@@ -15,11 +15,12 @@ using OperandsSequenceTrigger = OperatorTrates<OpAnd>::OperandsSequenceTrigger;
 
 void OpAnd::reevaluateImpl(SequenceView& operandView) {
     violation = 0;
-    cachedViolations.clear();
-    for (size_t i = 0; i < operandView.numberElements(); ++i) {
-        auto& operandChild = operand->view()->getMembers<BoolView>()[i];
-        UInt operandViolation = operandChild->view()->violation;
-        cachedViolations.insert(i, operandViolation);
+    cachedValues.clear();
+    violatingOperands.clear();
+    auto& members = operandView.getMembers<BoolView>();
+    for (size_t i = 0; i < members.size(); ++i) {
+        UInt operandViolation = members[i]->view()->violation;
+        recacheValue(i, operandViolation);
         if (operandViolation > 0) {
             violatingOperands.insert(i);
         }
@@ -27,6 +28,30 @@ void OpAnd::reevaluateImpl(SequenceView& operandView) {
     }
 }
 
+Int OpAnd::foldValueOf(UInt index) {
+    return operand->view()->getMembers<BoolView>()[index]->view()->violation;
+}
+
+void OpAnd::unrolledExprChanged(UInt index, Int& foldedValue) {
+    UInt newViolation = foldValueOf(index);
+    UInt oldViolation = exchange(foldedValue, newViolation);
+    if (!allOperandsAreDefined()) {
+        // violation is large whilst the operand is undefined and will be
+        // recalculated once it is defined again.
+        return;
+    }
+    if (oldViolation > 0 && newViolation == 0) {
+        violatingOperands.erase(index);
+    } else if (oldViolation == 0 && newViolation > 0) {
+        violatingOperands.insert(index);
+    }
+    changeValueDeferred([&]() {
+        violation -= oldViolation;
+        violation += newViolation;
+        return true;
+    });
+}
+
 void OpAnd::updateVarViolationsImpl(const ViolationContext& vioContext,
                                     ViolationContainer& vioContainer) {
     auto* boolVioContextTest =
@@ -40,18 +65,20 @@ void OpAnd::updateVarViolationsImpl(const ViolationContext& vioContext,
         }
         return;
     }
+    auto& members = operand->view()->getMembers<BoolView>();
     for (size_t violatingOperandIndex : violatingOperands) {
-        operand->view()
-            .get()
-            .getMembers<BoolView>()[violatingOperandIndex]
-            ->updateVarViolations(violation, vioContainer);
+        members[violatingOperandIndex]->updateVarViolations(violation,
+                                                            vioContainer);
     }
 }
 
-void OpAnd::copy(OpAnd&) const {}
+void OpAnd::copy(OpAnd& newOp) const {
+    newOp.fuseWithOperand = fuseWithOperand;
+}
 
 std::ostream& OpAnd::dumpState(std::ostream& os) const {
-    os << "OpAnd: violation=" << violation << endl;
+    os << "OpAnd: violation=" << violation
+       << ", fused=" << (fusedOperand != nullptr) << endl;
     vector<UInt> sortedViolatingOperands(violatingOperands.begin(),
                                          violatingOperands.end());
     sort(sortedViolatingOperands.begin(), sortedViolatingOperands.end());
@@ -63,6 +90,16 @@ std::pair<bool, ExprRef<BoolView>> OpAnd::optimiseImpl(ExprRef<BoolView>& self,
                                                        PathExtension path) {
     auto boolOpPair = standardOptimise(self, path);
     boolOpPair.first |= flatten<BoolView>(*(boolOpPair.second));
+    auto& newOp = *boolOpPair.second;
+    auto sequenceLitTest = getAs<OpSequenceLit>(newOp.operand);
+    if (sequenceLitTest) {
+        auto membersTest =
+            lib::get_if<ExprRefVec<BoolView>>(&(sequenceLitTest->members));
+        if (membersTest) {
+            boolOpPair.first |= mergeGccs(*membersTest);
+        }
+    }
+    markFusion(newOp);
     return boolOpPair;
 }
 
@@ -76,14 +113,20 @@ void OpAnd::debugSanityCheckImpl() const {
     }
     auto& operandView = *view;
     UInt calcViolation = 0;
-    for (auto& member : operandView.getMembers<BoolView>()) {
-        auto memberView = member->getViewIfDefined();
+    auto& members = operandView.getMembers<BoolView>();
+    sanityCheckCachedValues(members.size());
+    for (size_t i = 0; i < members.size(); i++) {
+        auto memberView = members[i]->getViewIfDefined();
         sanityCheck(memberView,
                     "View should not be undefined, it is a bool view.");
-        calcViolation += memberView->violation;
+        UInt memberViolation = memberView->violation;
+        calcViolation += memberViolation;
+        sanityEqualsCheck(memberViolation, (UInt)cachedValue(i));
+        bool memberViolated = memberViolation > 0;
+        bool recordedViolating = violatingOperands.count(i) == 1;
+        sanityEqualsCheck(memberViolated, recordedViolating);
     }
     sanityEqualsCheck(calcViolation, violation);
-    ;
 }
 
 template <typename Op>
@@ -109,3 +152,4 @@ ExprRef<BoolView> OpMaker<OpAnd>::make(
 }
 
 template struct SimpleUnaryOperator<BoolView, SequenceView, OpAnd>;
+template struct FoldingOperator<BoolView, OpAnd>;
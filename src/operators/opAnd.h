@@ -3,9 +3,8 @@
 #define SRC_OPERATORS_OPAND_H_
 #include <vector>
 
-#include "operators/previousValueCache.h"
+#include "operators/foldingOperator.h"
 #include "operators/shiftViolatingIndices.h"
-#include "operators/simpleOperator.h"
 #include "types/bool.h"
 #include "types/sequence.h"
 #include "utils/fastIterableIntSet.h"
@@ -17,10 +16,8 @@ struct OperatorTrates<OpAnd> {
     typedef OperandsSequenceTrigger OperandTrigger;
 };
 
-struct OpAnd : public SimpleUnaryOperator<BoolView, SequenceView, OpAnd> {
-    using SimpleUnaryOperator<BoolView, SequenceView,
-                              OpAnd>::SimpleUnaryOperator;
-    PreviousValueCache<UInt> cachedViolations;
+struct OpAnd : public FoldingOperator<BoolView, OpAnd> {
+    using FoldingOperator<BoolView, OpAnd>::FoldingOperator;
     FastIterableIntSet violatingOperands = FastIterableIntSet(0, 0);
 
     inline OpAnd& operator=(const OpAnd& other) {
@@ -30,6 +27,8 @@ struct OpAnd : public SimpleUnaryOperator<BoolView, SequenceView, OpAnd> {
     }
     OpAnd(OpAnd&&) = delete;
     void reevaluateImpl(SequenceView& operandView);
+    Int foldValueOf(UInt index) final;
+    void unrolledExprChanged(UInt index, Int& foldedValue) final;
     void updateVarViolationsImpl(const ViolationContext& vioContext,
                                  ViolationContainer& vioContainer) final;
     void copy(OpAnd& newOp) const;
@@ -49,10 +48,10 @@ class OperatorTrates<OpAnd>::OperandsSequenceTrigger : public SequenceTrigger {
         shiftIndicesUp(index, op->operand->view()->numberElements(),
                        op->violatingOperands);
         UInt violation = expr->view()->violation;
-        op->cachedViolations.insert(index, violation);
+        op->insertCachedValue(index, violation);
         if (violation > 0) {
             op->violatingOperands.insert(index);
-            op->changeValue([&]() {
+            op->changeValueDeferred([&]() {
                 op->violation += violation;
                 return true;
             });
@@ -60,16 +59,15 @@ class OperatorTrates<OpAnd>::OperandsSequenceTrigger : public SequenceTrigger {
     }
 
     void valueRemoved(UInt index, const AnyExprRef&) final {
-        UInt violationOfRemovedExpr = op->cachedViolations.get(index);
+        UInt violationOfRemovedExpr = op->eraseCachedValue(index);
         debug_code(assert((op->violatingOperands.count(index) &&
                            violationOfRemovedExpr > 0) ||
                           (!op->violatingOperands.count(index) &&
                            violationOfRemovedExpr == 0)));
         op->violatingOperands.erase(index);
-        op->cachedViolations.erase(index);
         shiftIndicesDown(index, op->operand->view()->numberElements(),
                          op->violatingOperands);
-        op->changeValue([&]() {
+        op->changeValueDeferred([&]() {
             op->violation -= violationOfRemovedExpr;
             return true;
         });
@@ -87,8 +85,7 @@ class OperatorTrates<OpAnd>::OperandsSequenceTrigger : public SequenceTrigger {
                 op->violatingOperands.insert(index1);
             }
         }
-        std::swap(op->cachedViolations.get(index1),
-                  op->cachedViolations.get(index2));
+        op->swapCachedValues(index1, index2);
     }
 
     UInt getViolation(size_t index) {
@@ -104,7 +101,7 @@ class OperatorTrates<OpAnd>::OperandsSequenceTrigger : public SequenceTrigger {
         UInt violationToAdd = 0, violationToRemove = 0;
         for (size_t i = startIndex; i < endIndex; i++) {
             UInt newViolation = getViolation(i);
-            UInt oldViolation = op->cachedViolations.getAndSet(i, newViolation);
+            UInt oldViolation = op->exchangeCachedValue(i, newViolation);
             violationToAdd += newViolation;
             violationToRemove += oldViolation;
             if (oldViolation > 0 && newViolation == 0) {
@@ -113,14 +110,14 @@ class OperatorTrates<OpAnd>::OperandsSequenceTrigger : public SequenceTrigger {
                 op->violatingOperands.insert(i);
             }
         }
-        op->changeValue([&]() {
+        op->changeValueDeferred([&]() {
             op->violation -= violationToRemove;
             op->violation += violationToAdd;
             return true;
         });
     }
     void valueChanged() final {
-        op->changeValue([&]() {
+        op->changeValueDeferred([&]() {
             op->reevaluate(true, true);
             return true;
         });
@@ -0,0 +1,228 @@
+#include "operators/opCount.h"
+
+#include <cassert>
+
+#include "operators/foldingOperator.hpp"
+#include "operators/opToInt.h"
+#include "operators/operatorMakers.h"
+#include "types/allTypes.h"
+#include "types/intVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+using OperandsSequenceTrigger =
+    OperatorTrates<OpCount>::OperandsSequenceTrigger;
+
+static inline Int truthOf(const ExprRef<BoolView>& expr) {
+    return expr->view()->violation == 0;
+}
+
+class OperatorTrates<OpCount>::OperandsSequenceTrigger
+    : public SequenceTrigger {
+   public:
+    OpCount* op;
+    OperandsSequenceTrigger(OpCount* op) : op(op) {}
+    void valueAdded(UInt index, const AnyExprRef& exprIn) final {
+        if (!op->isDefined()) {
+            return;
+        }
+        Int truth = truthOf(lib::get<ExprRef<BoolView>>(exprIn));
+        op->insertCachedValue(index, truth);
+        op->changeValueDeferred([&]() {
+            op->value += truth;
+            return truth != 0;
+        });
+    }
+
+    void valueRemoved(UInt index, const AnyExprRef&) final {
+        if (!op->isDefined()) {
+            return;
+        }
+        Int truth = op->eraseCachedValue(index);
+        op->changeValueDeferred([&]() {
+            op->value -= truth;
+            return truth != 0;
+        });
+    }
+
+    inline void positionsSwapped(UInt index1, UInt index2) {
+        if (!op->isDefined()) {
+            return;
+        }
+        op->swapCachedValues(index1, index2);
+    }
+
+    void memberReplaced(UInt index, const AnyExprRef&) final {
+        subsequenceChanged(index, index + 1);
+    }
+
+    void subsequenceChanged(UInt startIndex, UInt endIndex) final {
+        if (!op->isDefined()) {
+            return;
+        }
+        auto& members = op->operand->view()->getMembers<BoolView>();
+        Int delta = 0;
+        for (size_t i = startIndex; i < endIndex; i++) {
+            Int newTruth = truthOf(members[i]);
+            delta += newTruth - op->exchangeCachedValue(i, newTruth);
+        }
+        op->changeValueDeferred([&]() {
+            op->value += delta;
+            return delta != 0;
+        });
+    }
+
+    void valueChanged() final {
+        bool wasDefined = op->isDefined();
+        op->changeValueDeferred([&]() {
+            op->reevaluate();
+            return op->isDefined();
+        });
+        if (wasDefined && !op->isDefined()) {
+            op->notifyValueUndefined();
+        } else if (!wasDefined && op->isDefined()) {
+            op->notifyValueDefined();
+        }
+    }
+
+    void reattachTrigger() final {
+        auto trigger = make_shared<OperandsSequenceTrigger>(op);
+        op->operand->addTrigger(trigger);
+        op->operandTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { op->setUndefinedAndTrigger(); }
+    void hasBecomeDefined() final { op->reevaluateDefinedAndTrigger(); }
+    void memberHasBecomeUndefined(UInt) final { shouldNotBeCalledPanic; }
+    void memberHasBecomeDefined(UInt) final { shouldNotBeCalledPanic; }
+};
+
+void OpCount::reevaluateImpl(SequenceView& operandView) {
+    value = 0;
+    cachedValues.clear();
+    auto& members = operandView.getMembers<BoolView>();
+    for (size_t i = 0; i < members.size(); i++) {
+        Int truth = truthOf(members[i]);
+        recacheValue(i, truth);
+        value += truth;
+    }
+}
+
+Int OpCount::foldValueOf(UInt index) {
+    return truthOf(operand->view()->getMembers<BoolView>()[index]);
+}
+
+void OpCount::unrolledExprChanged(UInt index, Int& foldedValue) {
+    Int newTruth = foldValueOf(index);
+    Int oldTruth = exchange(foldedValue, newTruth);
+    if (!isDefined() || newTruth == oldTruth) {
+        return;
+    }
+    changeValueDeferred([&]() {
+        value += newTruth - oldTruth;
+        return true;
+    });
+}
+
+void OpCount::updateVarViolationsImpl(const ViolationContext& vioContext,
+                                      ViolationContainer& vioContainer) {
+    auto operandView = operand->view();
+    if (!operandView) {
+        operand->updateVarViolations(vioContext, vioContainer);
+        return;
+    }
+    for (auto& member : (*operandView).getMembers<BoolView>()) {
+        member->updateVarViolations(vioContext, vioContainer);
+    }
+}
+
+void OpCount::copy(OpCount& newOp) const {
+    newOp.fuseWithOperand = fuseWithOperand;
+}
+
+std::ostream& OpCount::dumpState(std::ostream& os) const {
+    os << "OpCount: defined=" << this->appearsDefined()
+       << ", fused=" << (fusedOperand != nullptr) << ", value=" << value
+       << endl;
+    return operand->dumpState(os);
+}
+
+std::pair<bool, ExprRef<IntView>> OpCount::optimiseImpl(ExprRef<IntView>& self,
+                                                        PathExtension path) {
+    auto optResult = standardOptimise(self, path);
+    auto& newOp = *optResult.second;
+    markFusion(newOp);
+    return optResult;
+}
+
+string OpCount::getOpName() const { return "OpCount"; }
+
+void OpCount::debugSanityCheckImpl() const {
+    operand->debugSanityCheck();
+    this->standardSanityDefinednessChecks();
+    auto view = operand->getViewIfDefined();
+    if (!view) {
+        return;
+    }
+    auto& members = view->getMembers<BoolView>();
+    sanityCheckCachedValues(members.size());
+    Int checkValue = 0;
+    for (size_t i = 0; i < members.size(); i++) {
+        Int truth = truthOf(members[i]);
+        checkValue += truth;
+        Int cachedTruth = cachedValue(i);
+        sanityEqualsCheck(truth, cachedTruth);
+    }
+    sanityEqualsCheck(checkValue, value);
+}
+
+// count the truths of expr over a copy of quant.  The copy keeps the
+// iterator, so expr may refer to it.
+template <typename Quant>
+static ExprRef<IntView> countOverQuantifier(const Quant& quant,
+                                            ExprRef<BoolView> expr,
+                                            bool keepCondition) {
+    auto newQuant = make_shared<Quant>(quant);
+    newQuant->setExpression(move(expr));
+    if (!keepCondition) {
+        newQuant->setCondition(nullptr);
+    }
+    return OpMaker<OpCount>::make(ExprRef<SequenceView>(newQuant));
+}
+
+lib::optional<ExprRef<IntView>> optimiseSumToCount(
+    const ExprRef<SequenceView>& operand) {
+    return visitQuantifier<ExprRef<IntView>>(
+        operand, [&](auto& quant) -> lib::optional<ExprRef<IntView>> {
+            auto exprTest = lib::get_if<ExprRef<IntView>>(&quant.expr);
+            if (!exprTest) {
+                return lib::nullopt;
+            }
+            auto toIntTest = getAs<OpToInt>(*exprTest);
+            if (!toIntTest) {
+                return lib::nullopt;
+            }
+            debug_log("Optimise: sum of toInt over quantifier to OpCount");
+            return countOverQuantifier(quant, toIntTest->operand, true);
+        });
+}
+
+lib::optional<ExprRef<IntView>> optimiseSequenceSizeToCount(
+    const ExprRef<SequenceView>& operand) {
+    return visitQuantifier<ExprRef<IntView>>(
+        operand, [&](auto& quant) -> lib::optional<ExprRef<IntView>> {
+            if (!quant.condition) {
+                return lib::nullopt;
+            }
+            debug_log("Optimise: size of quantifier to OpCount");
+            return countOverQuantifier(quant, quant.condition, false);
+        });
+}
+
+ExprRef<IntView> OpMaker<OpCount>::make(ExprRef<SequenceView> o) {
+    auto op = make_shared<OpCount>(move(o));
+    op->fuseWithOperand = getAs<QuantifierBase>(op->operand).hasValue();
+    return op;
+}
+
+template struct SimpleUnaryOperator<IntView, SequenceView, OpCount>;
+template struct FoldingOperator<IntView, OpCount>;
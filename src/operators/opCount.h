@@ -0,0 +1,64 @@
+
+#ifndef SRC_OPERATORS_OPCOUNT_H_
+#define SRC_OPERATORS_OPCOUNT_H_
+#include "operators/foldingOperator.h"
+#include "types/bool.h"
+#include "types/int.h"
+#include "types/sequence.h"
+
+// the number of bool operands that are true.  Not parsed directly, the
+// optimiser produces it from sum([toInt(c) | ...]) and from the size of a
+// comprehension with a condition.
+struct OpCount;
+template <>
+struct OperatorTrates<OpCount> {
+    class OperandsSequenceTrigger;
+    typedef OperandsSequenceTrigger OperandTrigger;
+};
+
+struct OpCount : public FoldingOperator<IntView, OpCount> {
+    using FoldingOperator<IntView, OpCount>::FoldingOperator;
+    OpCount(OpCount&&) = delete;
+    void reevaluateImpl(SequenceView& operandView);
+    Int foldValueOf(UInt index) final;
+    void unrolledExprChanged(UInt index, Int& foldedValue) final;
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpCount& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::pair<bool, ExprRef<IntView>> optimiseImpl(ExprRef<IntView>&,
+                                                   PathExtension path) final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+
+// calls func with operand as the quantifier type it is and returns its
+// result, returns nullopt if operand is not a quantifier.
+template <typename Result, typename Func>
+lib::optional<Result> visitQuantifier(const ExprRef<SequenceView>& operand,
+                                      Func&& func) {
+    if (auto quant = getAs<Quantifier<SetView>>(operand)) {
+        return func(*quant);
+    }
+    if (auto quant = getAs<Quantifier<MSetView>>(operand)) {
+        return func(*quant);
+    }
+    if (auto quant = getAs<Quantifier<SequenceView>>(operand)) {
+        return func(*quant);
+    }
+    if (auto quant = getAs<Quantifier<FunctionView>>(operand)) {
+        return func(*quant);
+    }
+    return lib::nullopt;
+}
+
+// if operand is a quantifier over toInt(c), returns a count of c over the
+// same quantifier, to replace the sum of operand.
+lib::optional<ExprRef<IntView>> optimiseSumToCount(
+    const ExprRef<SequenceView>& operand);
+// if operand is a quantifier with a condition, returns a count of the
+// condition over the same container, to replace the size of operand.
+lib::optional<ExprRef<IntView>> optimiseSequenceSizeToCount(
+    const ExprRef<SequenceView>& operand);
+
+#endif /* SRC_OPERATORS_OPCOUNT_H_ */
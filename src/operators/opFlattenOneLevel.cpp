@@ -145,7 +145,7 @@ struct OpFlattenOneLevel<SequenceInnerType>::OperandTrigger
     void valueChanged() {
         op->reevaluate();
         op->reattachAllInnerSequenceTriggers(true);
-        op->cachedHashTotal.invalidate();
+        op->cachedHashes.invalidate();
         op->notifyEntireValueChanged();
     }
 
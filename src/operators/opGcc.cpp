@@ -0,0 +1,550 @@
+#include "operators/opGcc.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "operators/intRange.h"
+#include "operators/opCount.h"
+#include "operators/opDiv.h"
+#include "operators/opFunctionImage.h"
+#include "operators/opIntEq.h"
+#include "operators/opMinus.h"
+#include "operators/opMod.h"
+#include "operators/opNegate.h"
+#include "operators/opProd.h"
+#include "operators/opSequenceIndex.h"
+#include "operators/opSequenceLit.h"
+#include "operators/opSubstringQuantify.h"
+#include "operators/opSum.h"
+#include "operators/opTupleIndex.h"
+#include "operators/opTupleLit.h"
+#include "operators/simpleOperator.hpp"
+#include "types/allTypes.h"
+#include "types/allVals.h"
+#include "types/intVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+using OperandsSequenceTrigger = OperatorTrates<OpGcc>::OperandsSequenceTrigger;
+
+void OpGcc::addBounds(Int value, UInt lowerBound, UInt upperBound) {
+    auto iter = valueIndices.find(value);
+    if (iter == valueIndices.end()) {
+        valueIndices.emplace(value, values.size());
+        values.push_back(value);
+        lowerBounds.push_back(lowerBound);
+        upperBounds.push_back(upperBound);
+        counts.push_back(0);
+        return;
+    }
+    UInt valueIndex = iter->second;
+    lowerBounds[valueIndex] = max(lowerBounds[valueIndex], lowerBound);
+    upperBounds[valueIndex] = min(upperBounds[valueIndex], upperBound);
+}
+
+Int OpGcc::countValue(Int value) {
+    auto iter = valueIndices.find(value);
+    if (iter == valueIndices.end()) {
+        return 0;
+    }
+    Int oldViolation = violationOf(iter->second);
+    ++counts[iter->second];
+    return (Int)violationOf(iter->second) - oldViolation;
+}
+
+Int OpGcc::uncountValue(Int value) {
+    auto iter = valueIndices.find(value);
+    if (iter == valueIndices.end()) {
+        return 0;
+    }
+    Int oldViolation = violationOf(iter->second);
+    --counts[iter->second];
+    return (Int)violationOf(iter->second) - oldViolation;
+}
+
+class OperatorTrates<OpGcc>::OperandsSequenceTrigger : public SequenceTrigger {
+   public:
+    OpGcc* op;
+    OperandsSequenceTrigger(OpGcc* op) : op(op) {}
+
+    void valueAdded(UInt index, const AnyExprRef& exprIn) final {
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        auto view = lib::get<ExprRef<IntView>>(exprIn)->getViewIfDefined();
+        if (!view) {
+            memberHasBecomeUndefined(index);
+            return;
+        }
+        Int value = (*view).value;
+        op->cachedValues.insert(index, value);
+        op->changeValue([&]() {
+            op->violation += op->countValue(value);
+            return true;
+        });
+    }
+
+    void valueRemoved(UInt index, const AnyExprRef&) final {
+        if (!op->allOperandsAreDefined()) {
+            // the removed member may have been the last undefined one.
+            if (op->operand->view()->numberUndefined == 0) {
+                op->reevaluateDefinedAndTrigger();
+            }
+            return;
+        }
+        Int value = op->cachedValues.erase(index);
+        op->changeValue([&]() {
+            op->violation += op->uncountValue(value);
+            return true;
+        });
+    }
+
+    inline void positionsSwapped(UInt index1, UInt index2) {
+        if (op->allOperandsAreDefined()) {
+            op->cachedValues.swap(index1, index2);
+        }
+    }
+
+    void memberReplaced(UInt index, const AnyExprRef&) final {
+        subsequenceChanged(index, index + 1);
+    }
+
+    void subsequenceChanged(UInt startIndex, UInt endIndex) final {
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        auto& members = op->operand->view()->getMembers<IntView>();
+        for (size_t i = startIndex; i < endIndex; i++) {
+            if (!members[i]->appearsDefined()) {
+                // that trigger will reach this op and the counts will be
+                // rebuilt once it is defined again.
+                return;
+            }
+        }
+        Int violationDelta = 0;
+        for (size_t i = startIndex; i < endIndex; i++) {
+            Int newValue = members[i]->view()->value;
+            Int oldValue = op->cachedValues.getAndSet(i, newValue);
+            if (newValue != oldValue) {
+                violationDelta += op->uncountValue(oldValue);
+                violationDelta += op->countValue(newValue);
+            }
+        }
+        op->changeValue([&]() {
+            op->violation += violationDelta;
+            return true;
+        });
+    }
+
+    void valueChanged() final {
+        op->changeValue([&]() {
+            op->reevaluate();
+            return op->allOperandsAreDefined();
+        });
+    }
+
+    void reattachTrigger() final {
+        auto trigger = make_shared<OperandsSequenceTrigger>(op);
+        op->operand->addTrigger(trigger);
+        op->operandTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { op->setUndefinedAndTrigger(); }
+    void hasBecomeDefined() final { op->reevaluateDefinedAndTrigger(); }
+    void memberHasBecomeUndefined(UInt) final {
+        if (op->operand->view()->numberUndefined == 1) {
+            op->setUndefinedAndTrigger();
+        }
+    }
+    void memberHasBecomeDefined(UInt) final {
+        if (op->operand->view()->numberUndefined == 0) {
+            op->reevaluateDefinedAndTrigger();
+        }
+    }
+};
+
+void OpGcc::reevaluateImpl(SequenceView& operandView) {
+    if (operandView.numberUndefined > 0) {
+        setDefined(false);
+        return;
+    }
+    fill(counts.begin(), counts.end(), 0);
+    cachedValues.clear();
+    auto& members = operandView.getMembers<IntView>();
+    for (size_t i = 0; i < members.size(); i++) {
+        Int value = members[i]->view()->value;
+        cachedValues.insert(i, value);
+        countValue(value);
+    }
+    violation = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        violation += violationOf(i);
+    }
+}
+
+void OpGcc::updateVarViolationsImpl(const ViolationContext& vioContext,
+                                    ViolationContainer& vioContainer) {
+    if (!allOperandsAreDefined()) {
+        operand->updateVarViolations(vioContext, vioContainer);
+        return;
+    }
+    auto& members = operand->view()->getMembers<IntView>();
+    auto* boolVioContextTest =
+        dynamic_cast<const BoolViolationContext*>(&vioContext);
+    if (boolVioContextTest && boolVioContextTest->negated) {
+        if (violation == 0) {
+            for (auto& member : members) {
+                member->updateVarViolations(1, vioContainer);
+            }
+        }
+        return;
+    }
+    UInt deficit = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (counts[i] < lowerBounds[i]) {
+            deficit += lowerBounds[i] - counts[i];
+        }
+    }
+    // members holding a value above its upper bound take that excess.  A
+    // deficit cannot be blamed on any one member, it is shared by the
+    // members whose value can be spared: values not counted or held more
+    // often than their lower bound requires.
+    size_t index = 0;
+    cachedValues.forEach([&](Int value) {
+        auto iter = valueIndices.find(value);
+        UInt memberViolation = deficit;
+        if (iter != valueIndices.end()) {
+            UInt valueIndex = iter->second;
+            if (counts[valueIndex] > upperBounds[valueIndex]) {
+                memberViolation = counts[valueIndex] - upperBounds[valueIndex];
+            } else if (counts[valueIndex] <= lowerBounds[valueIndex]) {
+                memberViolation = 0;
+            }
+        }
+        if (memberViolation > 0) {
+            members[index]->updateVarViolations(memberViolation, vioContainer);
+        }
+        ++index;
+    });
+}
+
+void OpGcc::copy(OpGcc& newOp) const {
+    newOp.values = values;
+    newOp.lowerBounds = lowerBounds;
+    newOp.upperBounds = upperBounds;
+    newOp.valueIndices = valueIndices;
+    newOp.counts.assign(counts.size(), 0);
+}
+
+std::ostream& OpGcc::dumpState(std::ostream& os) const {
+    os << "OpGcc: violation=" << violation << "\nvalues: " << values
+       << "\nlowerBounds: " << lowerBounds << "\nupperBounds: " << upperBounds
+       << "\ncounts: " << counts << endl;
+    return operand->dumpState(os) << ")";
+}
+
+string OpGcc::getOpName() const { return "OpGcc"; }
+
+void OpGcc::debugSanityCheckImpl() const {
+    operand->debugSanityCheck();
+    auto operandView = operand->getViewIfDefined();
+    if (!operandView) {
+        sanityLargeViolationCheck(violation);
+        return;
+    }
+    sanityEqualsCheck(values.size(), valueIndices.size());
+    auto& members = operandView->getMembers<IntView>();
+    sanityEqualsCheck(members.size(), cachedValues.size());
+    vector<UInt> checkCounts(values.size(), 0);
+    for (size_t i = 0; i < members.size(); i++) {
+        Int value = members[i]->view()->value;
+        sanityEqualsCheck(value, cachedValues.get(i));
+        auto iter = valueIndices.find(value);
+        if (iter != valueIndices.end()) {
+            ++checkCounts[iter->second];
+        }
+    }
+    UInt checkViolation = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        sanityEqualsCheck(checkCounts[i], counts[i]);
+        checkViolation += violationOf(i);
+    }
+    sanityEqualsCheck(checkViolation, violation);
+}
+
+static lib::optional<Int> getConstantValue(const ExprRef<IntView>& expr) {
+    if (!expr->isConstant()) {
+        return lib::nullopt;
+    }
+    expr->evaluate();
+    auto view = expr->getViewIfDefined();
+    return (view) ? lib::make_optional((*view).value) : lib::nullopt;
+}
+
+// bound the occurrences of value in expr over a copy of quant.  The copy
+// keeps the iterator, so expr may refer to it.
+template <typename Quant>
+static ExprRef<BoolView> gccOverQuantifier(const Quant& quant,
+                                           ExprRef<IntView> expr, Int value,
+                                           UInt lowerBound, UInt upperBound) {
+    auto newQuant = make_shared<Quant>(quant);
+    newQuant->setExpression(move(expr));
+    auto op = make_shared<OpGcc>(ExprRef<SequenceView>(newQuant));
+    op->addBounds(value, lowerBound, upperBound);
+    return op;
+}
+
+// if count is a count over a quantifier of expr = constant, returns an OpGcc
+// over the same quantifier of expr.
+static lib::optional<ExprRef<BoolView>> countToGcc(
+    const ExprRef<IntView>& count, Int lowerBound, Int upperBound) {
+    auto countTest = getAs<OpCount>(count);
+    if (!countTest || upperBound < 0 || lowerBound > upperBound) {
+        return lib::nullopt;
+    }
+    return visitQuantifier<ExprRef<BoolView>>(
+        countTest->operand,
+        [&](auto& quant) -> lib::optional<ExprRef<BoolView>> {
+            auto exprTest = lib::get_if<ExprRef<BoolView>>(&quant.expr);
+            if (!exprTest) {
+                return lib::nullopt;
+            }
+            auto eqTest = getAs<OpIntEq>(*exprTest);
+            if (!eqTest) {
+                return lib::nullopt;
+            }
+            auto value = getConstantValue(eqTest->right);
+            auto expr = eqTest->left;
+            if (!value) {
+                value = getConstantValue(eqTest->left);
+                expr = eqTest->right;
+            }
+            if (!value || expr->isConstant()) {
+                return lib::nullopt;
+            }
+            debug_log("Optimise: comparison of count with constant to OpGcc");
+            return gccOverQuantifier(quant, move(expr), *value,
+                                     max<Int>(lowerBound, 0), upperBound);
+        });
+}
+
+lib::optional<ExprRef<BoolView>> optimiseCountComparisonToGcc(
+    const ExprRef<IntView>& left, const ExprRef<IntView>& right,
+    CountComparison comparison) {
+    const Int noBound = numeric_limits<Int>::max();
+    auto rightValue = getConstantValue(right);
+    if (rightValue) {
+        switch (comparison) {
+            case CountComparison::LESS:
+                return countToGcc(left, 0, *rightValue - 1);
+            case CountComparison::LESS_EQ:
+                return countToGcc(left, 0, *rightValue);
+            case CountComparison::EQ:
+                return countToGcc(left, *rightValue, *rightValue);
+        }
+    }
+    auto leftValue = getConstantValue(left);
+    if (leftValue) {
+        switch (comparison) {
+            case CountComparison::LESS:
+                return countToGcc(right, *leftValue + 1, noBound);
+            case CountComparison::LESS_EQ:
+                return countToGcc(right, *leftValue, noBound);
+            case CountComparison::EQ:
+                return countToGcc(right, *leftValue, *leftValue);
+        }
+    }
+    return lib::nullopt;
+}
+
+// the window size if expr is a substring quantifier.
+template <typename View>
+static lib::optional<Int> substringWindowSize(const ExprRef<View>&) {
+    return lib::nullopt;
+}
+
+template <>
+lib::optional<Int> substringWindowSize<SequenceView>(
+    const ExprRef<SequenceView>& expr) {
+    lib::optional<Int> windowSize;
+#define windowSizeIfSubstring(name)                                            \
+    if (auto substringTest = getAs<OpSubstringQuantify<name##View>>(expr)) {   \
+        windowSize = substringTest->windowSize;                                \
+    }
+    buildForAllTypes(windowSizeIfSubstring, );
+#undef windowSizeIfSubstring
+    return windowSize;
+}
+
+// true if left, in which the iterator of leftQuantId may appear, and right,
+// in which the iterator of rightQuantId may appear, have the same value for
+// the same iterator value.  Only operators whose value is determined by their
+// type and operands are compared, anything else must be the same node.
+static bool sameUpToIterator(const AnyExprRef& left, UInt64 leftQuantId,
+                             const AnyExprRef& right, UInt64 rightQuantId) {
+    return lib::visit(
+        [&](auto& left) {
+            typedef viewType(left) View;
+            typedef typename AssociatedValueType<View>::type Value;
+            auto rightTest = lib::get_if<ExprRef<View>>(&right);
+            if (!rightTest) {
+                return false;
+            }
+            auto& right = *rightTest;
+            if (&(*left) == &(*right)) {
+                return true;
+            }
+            if (typeid(*left) != typeid(*right)) {
+                return false;
+            }
+            if (dynamic_cast<Value*>(&(*left))) {
+                return left->isConstant() && right->isConstant() &&
+                       getValueHash(*left->view()) ==
+                           getValueHash(*right->view());
+            }
+            auto leftIterTest = getAs<Iterator<View>>(left);
+            if (leftIterTest) {
+                UInt64 rightId = getAs<Iterator<View>>(right)->id;
+                return (leftIterTest->id == leftQuantId)
+                           ? rightId == rightQuantId
+                           : rightId == leftIterTest->id &&
+                                 rightId != rightQuantId;
+            }
+            auto leftTupleIndexTest = getAs<OpTupleIndex<View>>(left);
+            if (leftTupleIndexTest &&
+                leftTupleIndexTest->indexOperand !=
+                    getAs<OpTupleIndex<View>>(right)->indexOperand) {
+                return false;
+            }
+            auto leftWindowSize = substringWindowSize(left);
+            if (leftWindowSize &&
+                *leftWindowSize != *substringWindowSize(right)) {
+                return false;
+            }
+            if (!leftTupleIndexTest && !leftWindowSize &&
+                !getAs<IntRange>(left) &&
+                !getAs<OpSequenceIndex<View>>(left) &&
+                !getAs<OpFunctionImage<View>>(left) && !getAs<OpSum>(left) &&
+                !getAs<OpProd>(left) && !getAs<OpMinus>(left) &&
+                !getAs<OpDiv>(left) && !getAs<OpMod>(left) &&
+                !getAs<OpNegate>(left) && !getAs<OpSequenceLit>(left) &&
+                !getAs<OpTupleLit>(left)) {
+                return false;
+            }
+            vector<AnyExprRef> leftOperands, rightOperands;
+            auto collectInto = [](vector<AnyExprRef>& operands) {
+                return FindAndReplaceFunction(
+                    [&](AnyExprRef operand, const PathExtension&) {
+                        operands.emplace_back(operand);
+                        return make_pair(true, operand);
+                    });
+            };
+            left->findAndReplaceSelf(collectInto(leftOperands),
+                                     PathExtension::begin());
+            right->findAndReplaceSelf(collectInto(rightOperands),
+                                      PathExtension::begin());
+            if (leftOperands.size() != rightOperands.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < leftOperands.size(); i++) {
+                if (!sameUpToIterator(leftOperands[i], leftQuantId,
+                                      rightOperands[i], rightQuantId)) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        left);
+}
+
+// true if left and right have the same members.  Either they are the same
+// node or quantifiers without conditions that unroll the same expr over the
+// same container.
+static bool sameCollection(const ExprRef<SequenceView>& left,
+                           const ExprRef<SequenceView>& right) {
+    if (&(*left) == &(*right)) {
+        return true;
+    }
+    auto sameTest = visitQuantifier<bool>(left, [&](auto& leftQuant) {
+        typedef BaseType<decltype(leftQuant)> Quant;
+        auto rightQuantTest = getAs<Quant>(right);
+        if (!rightQuantTest) {
+            return false;
+        }
+        auto& rightQuant = *rightQuantTest;
+        return !leftQuant.condition && !rightQuant.condition &&
+               leftQuant.optimisedToNotUpdateIndices ==
+                   rightQuant.optimisedToNotUpdateIndices &&
+               sameUpToIterator(leftQuant.container, leftQuant.quantId,
+                                rightQuant.container, rightQuant.quantId) &&
+               sameUpToIterator(leftQuant.expr, leftQuant.quantId,
+                                rightQuant.expr, rightQuant.quantId);
+    });
+    return sameTest && *sameTest;
+}
+
+bool mergeGccs(ExprRefVec<BoolView>& conjuncts) {
+    bool merged = false;
+    for (size_t i = 0; i < conjuncts.size(); i++) {
+        auto gccTest = getAs<OpGcc>(conjuncts[i]);
+        if (!gccTest) {
+            continue;
+        }
+        shared_ptr<OpGcc> mergedGcc;
+        size_t j = i + 1;
+        while (j < conjuncts.size()) {
+            auto otherTest = getAs<OpGcc>(conjuncts[j]);
+            if (!otherTest ||
+                !sameCollection(gccTest->operand, otherTest->operand)) {
+                ++j;
+                continue;
+            }
+            if (!mergedGcc) {
+                // a new op, the original may be shared with other parents.
+                mergedGcc = make_shared<OpGcc>(gccTest->operand);
+                for (size_t k = 0; k < gccTest->values.size(); k++) {
+                    mergedGcc->addBounds(gccTest->values[k],
+                                         gccTest->lowerBounds[k],
+                                         gccTest->upperBounds[k]);
+                }
+            }
+            for (size_t k = 0; k < otherTest->values.size(); k++) {
+                mergedGcc->addBounds(otherTest->values[k],
+                                     otherTest->lowerBounds[k],
+                                     otherTest->upperBounds[k]);
+            }
+            conjuncts.erase(conjuncts.begin() + j);
+        }
+        if (mergedGcc) {
+            debug_log("Optimise: merging OpGcc over the same collection");
+            mergedGcc->setConstant(gccTest->isConstant());
+            conjuncts[i] = mergedGcc;
+            merged = true;
+        }
+    }
+    return merged;
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <>
+struct OpMaker<OpGcc> {
+    static ExprRef<BoolView> make(ExprRef<SequenceView> o,
+                                  const std::vector<Int>& values,
+                                  const std::vector<UInt>& lowerBounds,
+                                  const std::vector<UInt>& upperBounds);
+};
+
+ExprRef<BoolView> OpMaker<OpGcc>::make(ExprRef<SequenceView> o,
+                                       const vector<Int>& values,
+                                       const vector<UInt>& lowerBounds,
+                                       const vector<UInt>& upperBounds) {
+    auto op = make_shared<OpGcc>(move(o));
+    for (size_t i = 0; i < values.size(); i++) {
+        op->addBounds(values[i], lowerBounds[i], upperBounds[i]);
+    }
+    return op;
+}
+
+template struct SimpleUnaryOperator<BoolView, SequenceView, OpGcc>;
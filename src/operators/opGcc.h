@@ -0,0 +1,73 @@
+
+#ifndef SRC_OPERATORS_OPGCC_H_
+#define SRC_OPERATORS_OPGCC_H_
+#include <vector>
+
+#include "operators/previousValueCache.h"
+#include "operators/simpleOperator.h"
+#include "types/bool.h"
+#include "types/int.h"
+#include "types/sequence.h"
+
+// global cardinality: the number of int operands equal to values[i] must lie
+// between lowerBounds[i] and upperBounds[i].  Parsed from atmost, atleast and
+// gcc, the optimiser also produces it from a count of operands equal to a
+// constant compared with a constant.
+struct OpGcc;
+template <>
+struct OperatorTrates<OpGcc> {
+    class OperandsSequenceTrigger;
+    typedef OperandsSequenceTrigger OperandTrigger;
+};
+
+struct OpGcc : public SimpleUnaryOperator<BoolView, SequenceView, OpGcc> {
+    using SimpleUnaryOperator<BoolView, SequenceView,
+                              OpGcc>::SimpleUnaryOperator;
+    std::vector<Int> values;
+    std::vector<UInt> lowerBounds;
+    std::vector<UInt> upperBounds;
+    // maps a value to its index in values
+    HashMap<Int, UInt> valueIndices;
+    // number of operands equal to each of values
+    std::vector<UInt> counts;
+    // the value of each operand as last counted
+    PreviousValueCache<Int> cachedValues;
+    OpGcc(OpGcc&&) = delete;
+    // constrain the number of operands equal to value, tightening the bounds
+    // already given if value was added before.
+    void addBounds(Int value, UInt lowerBound, UInt upperBound);
+    inline UInt violationOf(size_t valueIndex) const {
+        UInt count = counts[valueIndex];
+        if (count > upperBounds[valueIndex]) {
+            return count - upperBounds[valueIndex];
+        }
+        return (count < lowerBounds[valueIndex])
+                   ? lowerBounds[valueIndex] - count
+                   : 0;
+    }
+    // add or remove an occurrence of value, returns the change in violation.
+    Int countValue(Int value);
+    Int uncountValue(Int value);
+    void reevaluateImpl(SequenceView& operandView);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpGcc& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+
+enum class CountComparison { LESS, LESS_EQ, EQ };
+// if one side of left comparison right is a count of the operands of a
+// quantifier equal to a constant, and the other side is a constant, returns
+// an OpGcc over the same quantifier to replace the comparison.
+lib::optional<ExprRef<BoolView>> optimiseCountComparisonToGcc(
+    const ExprRef<IntView>& left, const ExprRef<IntView>& right,
+    CountComparison comparison);
+
+// replaces the OpGcc members of conjuncts over the same collection by a
+// single OpGcc bounding all of their values, so the collection is counted
+// once.  Returns true if any were merged.
+bool mergeGccs(ExprRefVec<BoolView>& conjuncts);
+
+#endif /* SRC_OPERATORS_OPGCC_H_ */
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <memory>
 
+#include "operators/opInIntDomain.h"
+#include "operators/opTable.h"
 #include "triggers/allTriggers.h"
 #include "utils/ignoreUnused.h"
 using namespace std;
@@ -171,6 +173,14 @@ pair<bool, ExprRef<BoolView>> OpIn::optimiseImpl(ExprRef<BoolView>&,
         [&](auto& expr) { optimised |= optimise(newOpAsExpr, expr, path); },
         newOp->expr);
     optimised |= optimise(newOpAsExpr, newOp->setOperand, path);
+    auto table = optimiseTupleInConstantSet(newOp->expr, newOp->setOperand);
+    if (table) {
+        return make_pair(true, *table);
+    }
+    auto inDomain = optimiseIntInConstantSet(newOp->expr, newOp->setOperand);
+    if (inDomain) {
+        return make_pair(true, *inDomain);
+    }
     return make_pair(optimised, newOp);
 }
 
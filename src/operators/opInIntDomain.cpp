@@ -1,5 +1,6 @@
 #include "operators/opInIntDomain.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <tuple>
@@ -109,7 +110,7 @@ void OpInDomain<IntView>::debugSanityCheckImpl() const {
         }
         if (v > bound.second && v < nextBound.first) {
             Int distanceToBound = v - bound.second;
-            Int distanceToNextBound = nextBound.second - v;
+            Int distanceToNextBound = nextBound.first - v;
             sanityEqualsCheck(
                 tie(violation, closestBound, reason),
                 ((distanceToBound < distanceToNextBound)
@@ -122,6 +123,42 @@ void OpInDomain<IntView>::debugSanityCheckImpl() const {
     myAbort();
 }
 
+lib::optional<ExprRef<BoolView>> optimiseIntInConstantSet(
+    const AnyExprRef& expr, const ExprRef<SetView>& set) {
+    auto intTest = lib::get_if<ExprRef<IntView>>(&expr);
+    if (!intTest || !set->isConstant()) {
+        return lib::nullopt;
+    }
+    set->evaluate();
+    auto setView = set->getViewIfDefined();
+    if (!setView || setView->numberElements() == 0 ||
+        !lib::get_if<ExprRefVec<IntView>>(&setView->members)) {
+        return lib::nullopt;
+    }
+    vector<Int> values;
+    for (auto& member : setView->getMembers<IntView>()) {
+        auto memberView = member->getViewIfDefined();
+        if (!memberView) {
+            return lib::nullopt;
+        }
+        values.emplace_back((*memberView).value);
+    }
+    sort(values.begin(), values.end());
+    // runs of consecutive values become one bound.
+    vector<pair<Int, Int>> bounds;
+    for (Int value : values) {
+        if (!bounds.empty() && bounds.back().second + 1 == value) {
+            bounds.back().second = value;
+        } else {
+            bounds.emplace_back(value, value);
+        }
+    }
+    debug_log("Optimise: int in constant set to OpInDomain");
+    auto op = make_shared<OpInDomain<IntView>>(*intTest);
+    op->domain = make_shared<IntDomain>(move(bounds));
+    return ExprRef<BoolView>(op);
+}
+
 template <typename Op>
 struct OpMaker;
 
@@ -6,6 +6,7 @@
 #include "types/bool.h"
 #include "types/int.h"
 #include "types/intVal.h"
+#include "types/set.h"
 template <typename View>
 struct OpInDomain;
 
@@ -36,4 +37,10 @@ struct OpInDomain<IntView>
     std::string getOpName() const final;
     void debugSanityCheckImpl() const final;
 };
+
+// if expr is an int and set is a nonempty constant set of ints, returns an
+// OpInDomain over the values of set to replace expr in set.  Its violation is
+// the distance to the nearest value rather than 0 or 1.
+lib::optional<ExprRef<BoolView>> optimiseIntInConstantSet(
+    const AnyExprRef& expr, const ExprRef<SetView>& set);
 #endif /* SRC_OPERATORS_OPININTDOMAIN_H_ */
@@ -2,6 +2,7 @@
 
 #include "operators/definedVarHelper.hpp"
 #include "operators/opAnd.h"
+#include "operators/opGcc.h"
 #include "operators/simpleOperator.hpp"
 #include "types/intVal.h"
 using namespace std;
@@ -59,6 +60,11 @@ void OpIntEq::copy(OpIntEq& newOp) const {
 pair<bool, ExprRef<BoolView>> OpIntEq::optimiseImpl(ExprRef<BoolView>& self,
                                                     PathExtension path) {
     auto newOp = standardOptimise(self, path);
+    auto gcc = optimiseCountComparisonToGcc(
+        newOp.second->left, newOp.second->right, CountComparison::EQ);
+    if (gcc) {
+        return make_pair(true, *gcc);
+    }
     newOp.second->definesLock = definesLock;
     if (isSuitableForDefiningVars(path)) {
         newOp.first |= newOp.second->definesLock.reset();
@@ -1,5 +1,6 @@
 #include "operators/opLess.h"
 
+#include "operators/opGcc.h"
 #include "operators/simpleOperator.hpp"
 using namespace std;
 void OpLess::reevaluateImpl(IntView& leftView, IntView& rightView, bool, bool) {
@@ -27,6 +28,17 @@ void OpLess::updateVarViolationsImpl(const ViolationContext&,
 }
 void OpLess::copy(OpLess&) const {}
 
+pair<bool, ExprRef<BoolView>> OpLess::optimiseImpl(ExprRef<BoolView>& self,
+                                                   PathExtension path) {
+    auto newOp = standardOptimise(self, path);
+    auto gcc = optimiseCountComparisonToGcc(
+        newOp.second->left, newOp.second->right, CountComparison::LESS);
+    if (gcc) {
+        return make_pair(true, *gcc);
+    }
+    return newOp;
+}
+
 ostream& OpLess::dumpState(ostream& os) const {
     os << "OpLess: violation=" << violation << "\nleft: ";
     left->dumpState(os);
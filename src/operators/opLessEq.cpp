@@ -1,5 +1,6 @@
 #include "operators/opLessEq.h"
 
+#include "operators/opGcc.h"
 #include "operators/simpleOperator.hpp"
 using namespace std;
 void OpLessEq::reevaluateImpl(IntView& leftView, IntView& rightView, bool,
@@ -28,6 +29,17 @@ void OpLessEq::updateVarViolationsImpl(const ViolationContext&,
 }
 void OpLessEq::copy(OpLessEq&) const {}
 
+pair<bool, ExprRef<BoolView>> OpLessEq::optimiseImpl(ExprRef<BoolView>& self,
+                                                     PathExtension path) {
+    auto newOp = standardOptimise(self, path);
+    auto gcc = optimiseCountComparisonToGcc(
+        newOp.second->left, newOp.second->right, CountComparison::LESS_EQ);
+    if (gcc) {
+        return make_pair(true, *gcc);
+    }
+    return newOp;
+}
+
 ostream& OpLessEq::dumpState(ostream& os) const {
     os << "OpLessEq: violation=" << violation << "\nleft: ";
     left->dumpState(os);
@@ -21,6 +21,8 @@ struct OpLessEq
     void updateVarViolationsImpl(const ViolationContext& vioContext,
                                  ViolationContainer& vioContainer) final;
     void copy(OpLessEq& newOp) const;
+    std::pair<bool, ExprRef<BoolView>> optimiseImpl(ExprRef<BoolView>& self,
+                                                    PathExtension path) final;
     std::ostream& dumpState(std::ostream& os) const final;
     std::string getOpName() const final;
     void debugSanityCheckImpl() const final;
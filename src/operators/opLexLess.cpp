@@ -0,0 +1,297 @@
+#include "operators/opLexLess.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "types/sequenceVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+
+template <bool strict>
+void OpLex<strict>::reevaluateImpl(SequenceView&, SequenceView&, bool, bool) {
+    differingIndices.clear();
+    rescanFrom(0);
+    this->violation = calcViolation();
+}
+
+template <bool strict>
+bool OpLex<strict>::updateDifference(UInt index) {
+    auto& leftMembers = this->left->view()->template getMembers<IntView>();
+    auto& rightMembers = this->right->view()->template getMembers<IntView>();
+    if (index >= leftMembers.size() || index >= rightMembers.size()) {
+        differingIndices.erase(index);
+        return true;
+    }
+    auto leftView = leftMembers[index]->getViewIfDefined();
+    auto rightView = rightMembers[index]->getViewIfDefined();
+    if (!leftView || !rightView) {
+        return false;
+    }
+    if ((*leftView).value != (*rightView).value) {
+        differingIndices.insert(index);
+    } else {
+        differingIndices.erase(index);
+    }
+    return true;
+}
+
+template <bool strict>
+void OpLex<strict>::rescanFrom(UInt index) {
+    differingIndices.erase(differingIndices.lower_bound(index),
+                           differingIndices.end());
+    UInt commonSize = min(this->left->view()->numberElements(),
+                          this->right->view()->numberElements());
+    for (UInt i = index; i < commonSize; i++) {
+        updateDifference(i);
+    }
+}
+
+template <bool strict>
+UInt OpLex<strict>::calcViolation() const {
+    auto& leftMembers = this->left->view()->template getMembers<IntView>();
+    auto& rightMembers = this->right->view()->template getMembers<IntView>();
+    if (differingIndices.empty()) {
+        if (leftMembers.size() < rightMembers.size()) {
+            return 0;
+        }
+        return (strict || leftMembers.size() > rightMembers.size()) ? 1 : 0;
+    }
+    UInt index = *differingIndices.begin();
+    Int diff = leftMembers[index]->view()->value -
+               rightMembers[index]->view()->value;
+    return (diff < 0) ? 0 : diff;
+}
+
+template <bool strict>
+void OpLex<strict>::updateViolationAndTrigger() {
+    this->changeValue([&]() {
+        this->violation = calcViolation();
+        return true;
+    });
+}
+
+template <bool strict>
+template <bool isLeft>
+class OperatorTrates<OpLex<strict>>::OperandTrigger : public SequenceTrigger {
+   public:
+    OpLex<strict>* op;
+    OperandTrigger(OpLex<strict>* op) : op(op) {}
+
+    void valueAdded(UInt index, const AnyExprRef& member) final {
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        if (!appearsDefined(member)) {
+            memberHasBecomeUndefined(index);
+            return;
+        }
+        op->rescanFrom(index);
+        op->updateViolationAndTrigger();
+    }
+
+    void valueRemoved(UInt index, const AnyExprRef&) final {
+        if (!op->allOperandsAreDefined()) {
+            // the removed member may have been the last undefined one.
+            memberHasBecomeDefined(index);
+            return;
+        }
+        op->rescanFrom(index);
+        op->updateViolationAndTrigger();
+    }
+
+    inline void positionsSwapped(UInt index1, UInt index2) {
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        op->updateDifference(index1);
+        op->updateDifference(index2);
+        op->updateViolationAndTrigger();
+    }
+
+    void memberReplaced(UInt index, const AnyExprRef&) final {
+        subsequenceChanged(index, index + 1);
+    }
+
+    void subsequenceChanged(UInt startIndex, UInt endIndex) final {
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        for (size_t i = startIndex; i < endIndex; i++) {
+            if (!op->updateDifference(i)) {
+                // that trigger will reach this op and the differences will
+                // be rescanned once it is defined again.
+                return;
+            }
+        }
+        op->updateViolationAndTrigger();
+    }
+
+    void valueChanged() final {
+        op->changeValue([&]() {
+            op->reevaluate(isLeft, !isLeft);
+            return true;
+        });
+    }
+
+    inline void reattachTrigger() final {
+        if (isLeft) {
+            reassignLeftTrigger();
+        } else {
+            reassignRightTrigger();
+        }
+    }
+    inline void reassignLeftTrigger() {
+        auto trigger = make_shared<OperandTrigger<true>>(op);
+        op->left->addTrigger(trigger);
+        op->leftTrigger = trigger;
+    }
+    inline void reassignRightTrigger() {
+        auto trigger = make_shared<OperandTrigger<false>>(op);
+        op->right->addTrigger(trigger);
+        op->rightTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { op->setUndefinedAndTrigger(); }
+    void hasBecomeDefined() final { memberHasBecomeDefined(0); }
+    void memberHasBecomeUndefined(UInt) final {
+        if (op->allOperandsAreDefined()) {
+            op->setUndefinedAndTrigger();
+        }
+    }
+    void memberHasBecomeDefined(UInt) final {
+        if (op->left->appearsDefined() && op->right->appearsDefined()) {
+            op->reevaluateDefinedAndTrigger();
+        }
+    }
+};
+
+template <bool strict>
+void OpLex<strict>::updateVarViolationsImpl(const ViolationContext& vioContext,
+                                            ViolationContainer& vioContainer) {
+    if (!this->allOperandsAreDefined()) {
+        this->left->updateVarViolations(vioContext, vioContainer);
+        this->right->updateVarViolations(vioContext, vioContainer);
+        return;
+    }
+    auto& leftMembers = this->left->view()->template getMembers<IntView>();
+    auto& rightMembers = this->right->view()->template getMembers<IntView>();
+    auto* boolVioContextTest =
+        dynamic_cast<const BoolViolationContext*>(&vioContext);
+    if (boolVioContextTest && boolVioContextTest->negated) {
+        if (this->violation > 0) {
+            return;
+        }
+        // the order is decided by the members up to the first difference,
+        // or by the lengths if there is none.
+        UInt end = min(leftMembers.size(), rightMembers.size());
+        if (!differingIndices.empty()) {
+            end = *differingIndices.begin() + 1;
+        } else {
+            this->left->updateVarViolations(1, vioContainer);
+            this->right->updateVarViolations(1, vioContainer);
+        }
+        for (size_t i = 0; i < end; i++) {
+            leftMembers[i]->updateVarViolations(1, vioContainer);
+            rightMembers[i]->updateVarViolations(1, vioContainer);
+        }
+        return;
+    }
+    if (this->violation == 0) {
+        return;
+    }
+    if (differingIndices.empty()) {
+        // equal up to the end of the shorter, only the lengths can change
+        // the order.
+        this->left->updateVarViolations(this->violation, vioContainer);
+        this->right->updateVarViolations(this->violation, vioContainer);
+        return;
+    }
+    UInt index = *differingIndices.begin();
+    leftMembers[index]->updateVarViolations(
+        IntViolationContext(this->violation,
+                            IntViolationContext::Reason::TOO_LARGE),
+        vioContainer);
+    rightMembers[index]->updateVarViolations(
+        IntViolationContext(this->violation,
+                            IntViolationContext::Reason::TOO_SMALL),
+        vioContainer);
+}
+
+template <bool strict>
+void OpLex<strict>::copy(OpLex<strict>&) const {}
+
+template <bool strict>
+std::ostream& OpLex<strict>::dumpState(std::ostream& os) const {
+    os << getOpName() << ": violation=" << this->violation
+       << "\ndifferingIndices: "
+       << vector<UInt>(differingIndices.begin(), differingIndices.end())
+       << "\nleft: ";
+    this->left->dumpState(os);
+    os << "\nright: ";
+    this->right->dumpState(os);
+    return os;
+}
+
+template <bool strict>
+string OpLex<strict>::getOpName() const {
+    return (strict) ? "OpLexLess" : "OpLexLessEq";
+}
+
+template <bool strict>
+void OpLex<strict>::debugSanityCheckImpl() const {
+    this->left->debugSanityCheck();
+    this->right->debugSanityCheck();
+    auto leftOption = this->left->getViewIfDefined();
+    auto rightOption = this->right->getViewIfDefined();
+    if (!leftOption || !rightOption) {
+        sanityLargeViolationCheck(this->violation);
+        return;
+    }
+    auto& leftMembers = leftOption->template getMembers<IntView>();
+    auto& rightMembers = rightOption->template getMembers<IntView>();
+    vector<UInt> checkDifferingIndices;
+    for (size_t i = 0; i < min(leftMembers.size(), rightMembers.size());
+         i++) {
+        if (leftMembers[i]->view()->value != rightMembers[i]->view()->value) {
+            checkDifferingIndices.emplace_back(i);
+        }
+    }
+    sanityEqualsCheck(
+        checkDifferingIndices,
+        vector<UInt>(differingIndices.begin(), differingIndices.end()));
+    UInt checkViolation;
+    if (checkDifferingIndices.empty()) {
+        checkViolation = (leftMembers.size() > rightMembers.size() ||
+                          (strict && leftMembers.size() == rightMembers.size()))
+                             ? 1
+                             : 0;
+    } else {
+        UInt index = checkDifferingIndices.front();
+        Int diff = leftMembers[index]->view()->value -
+                   rightMembers[index]->view()->value;
+        checkViolation = max<Int>(diff, 0);
+    }
+    sanityEqualsCheck(checkViolation, this->violation);
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <bool strict>
+struct OpMaker<OpLex<strict>> {
+    static ExprRef<BoolView> make(ExprRef<SequenceView> l,
+                                  ExprRef<SequenceView> r);
+};
+
+template <bool strict>
+ExprRef<BoolView> OpMaker<OpLex<strict>>::make(ExprRef<SequenceView> l,
+                                               ExprRef<SequenceView> r) {
+    return make_shared<OpLex<strict>>(move(l), move(r));
+}
+
+template struct OpLex<true>;
+template struct OpMaker<OpLex<true>>;
+template struct OpLex<false>;
+template struct OpMaker<OpLex<false>>;
@@ -0,0 +1,52 @@
+
+#ifndef SRC_OPERATORS_OPLEXLESS_H_
+#define SRC_OPERATORS_OPLEXLESS_H_
+#include <set>
+
+#include "operators/simpleOperator.h"
+#include "types/bool.h"
+#include "types/sequence.h"
+// left is lexicographically less than (or equal to when not strict) right,
+// both are sequences of ints.  A proper prefix is less than the sequence it
+// prefixes.
+template <bool strict>
+struct OpLex;
+template <bool strict>
+struct OperatorTrates<OpLex<strict>> {
+    template <bool isLeft>
+    class OperandTrigger;
+    typedef OperandTrigger<true> LeftTrigger;
+    typedef OperandTrigger<false> RightTrigger;
+};
+
+template <bool strict>
+struct OpLex
+    : public SimpleBinaryOperator<BoolView, SequenceView, SequenceView,
+                                  OpLex<strict>> {
+    using SimpleBinaryOperator<BoolView, SequenceView, SequenceView,
+                               OpLex<strict>>::SimpleBinaryOperator;
+    // the positions, within the length of the shorter operand, at which the
+    // operands differ.  Only the first decides the order.
+    std::set<UInt> differingIndices;
+
+    void reevaluateImpl(SequenceView& leftView, SequenceView& rightView, bool,
+                        bool);
+    // record whether the operands differ at index, returns false if a member
+    // at index is undefined.
+    bool updateDifference(UInt index);
+    // recalculate the differing positions from index onwards, called when
+    // members are added or removed.
+    void rescanFrom(UInt index);
+    // set violation from the first differing position and notify parents.
+    void updateViolationAndTrigger();
+    UInt calcViolation() const;
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpLex& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+typedef OpLex<true> OpLexLess;
+typedef OpLex<false> OpLexLessEq;
+#endif /* SRC_OPERATORS_OPLEXLESS_H_ */
@@ -0,0 +1,398 @@
+#include "operators/opLinear.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include "operators/foldingOperator.hpp"
+#include "operators/opCount.h"
+#include "operators/opNegate.h"
+#include "operators/opProd.h"
+#include "operators/opSequenceLit.h"
+#include "operators/operatorMakers.h"
+#include "types/intVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+using OperandsSequenceTrigger =
+    OperatorTrates<OpLinear>::OperandsSequenceTrigger;
+
+static inline Int getValueCatchUndef(const ExprRef<IntView>& expr) {
+    auto view = expr->getViewIfDefined();
+    return (view) ? (*view).value : 0;
+}
+
+Int OpLinear::foldInOperand(SequenceView& operandView, UInt index) {
+    Int newValue =
+        getValueCatchUndef(operandView.getMembers<IntView>()[index]);
+    Int delta =
+        coefficients[index] * (newValue - exchangeCachedValue(index, newValue));
+    value += delta;
+    return delta;
+}
+
+Int OpLinear::foldValueOf(UInt index) {
+    return getValueCatchUndef(operand->view()->getMembers<IntView>()[index]);
+}
+
+void OpLinear::unrolledExprChanged(UInt index, Int& foldedValue) {
+    Int newValue = foldValueOf(index);
+    Int delta = coefficients[index] * (newValue - exchange(foldedValue,
+                                                           newValue));
+    if (!evaluationComplete) {
+        return;
+    }
+    changeValueDeferred([&]() {
+        value += delta;
+        return delta != 0 && isDefined();
+    });
+}
+
+class OperatorTrates<OpLinear>::OperandsSequenceTrigger
+    : public SequenceTrigger {
+   public:
+    OpLinear* op;
+    OperandsSequenceTrigger(OpLinear* op) : op(op) {}
+    // the members of the operand are fixed, see OpLinear.
+    void valueAdded(UInt, const AnyExprRef&) final { shouldNotBeCalledPanic; }
+    void valueRemoved(UInt, const AnyExprRef&) final {
+        shouldNotBeCalledPanic;
+    }
+    void positionsSwapped(UInt, UInt) final { shouldNotBeCalledPanic; }
+
+    void memberReplaced(UInt index, const AnyExprRef&) final {
+        subsequenceChanged(index, index + 1);
+    }
+
+    void subsequenceChanged(UInt startIndex, UInt endIndex) final {
+        if (!op->evaluationComplete) {
+            return;
+        }
+        auto& operandView = *op->operand->view();
+        op->changeValueDeferred([&]() {
+            Int delta = 0;
+            for (size_t i = startIndex; i < endIndex; i++) {
+                delta += op->foldInOperand(operandView, i);
+            }
+            return delta != 0 && op->isDefined();
+        });
+    }
+
+    void valueChanged() final {
+        bool wasDefined = op->isDefined();
+        op->evaluationComplete = false;
+        op->changeValueDeferred([&]() {
+            op->reevaluate();
+            return op->isDefined();
+        });
+        if (wasDefined && !op->isDefined()) {
+            op->notifyValueUndefined();
+        } else if (!wasDefined && op->isDefined()) {
+            op->notifyValueDefined();
+        }
+    }
+
+    void reattachTrigger() final {
+        auto trigger = make_shared<OperandsSequenceTrigger>(op);
+        op->operand->addTrigger(trigger);
+        op->operandTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final {}
+    void hasBecomeDefined() final {}
+
+    void memberHasBecomeUndefined(UInt index) final {
+        if (!op->evaluationComplete) {
+            return;
+        }
+        op->foldInOperand(*op->operand->view(), index);
+        if (op->operand->view()->numberUndefined == 1) {
+            op->setUndefinedAndTrigger();
+        }
+    }
+
+    void memberHasBecomeDefined(UInt index) final {
+        auto& operandView = *op->operand->view();
+        if (!op->evaluationComplete) {
+            if (operandView.numberUndefined == 0) {
+                op->reevaluateDefinedAndTrigger();
+            }
+            return;
+        }
+        op->foldInOperand(operandView, index);
+        if (operandView.numberUndefined == 0) {
+            op->setDefinedAndTrigger();
+        }
+    }
+};
+
+void OpLinear::reevaluateImpl(SequenceView& operandView) {
+    setDefined(true);
+    value = constant;
+    cachedValues.clear();
+    auto& members = operandView.getMembers<IntView>();
+    for (size_t i = 0; i < members.size(); i++) {
+        if (!members[i]->appearsDefined()) {
+            setDefined(false);
+        }
+        recacheValue(i, 0);
+        foldInOperand(operandView, i);
+    }
+    evaluationComplete = true;
+}
+
+void OpLinear::updateVarViolationsImpl(const ViolationContext& vioContext,
+                                       ViolationContainer& vioContainer) {
+    auto& members = operand->view()->getMembers<IntView>();
+    const IntViolationContext* intVioContextTest =
+        dynamic_cast<const IntViolationContext*>(&vioContext);
+    for (size_t i = 0; i < members.size(); i++) {
+        // a term moves the value by |coefficient| per unit, so its variables
+        // take a proportional share of the violation.  A negative
+        // coefficient also reverses the direction the term should move in.
+        UInt termViolation = vioContext.parentViolation * abs(coefficients[i]);
+        if (!intVioContextTest) {
+            members[i]->updateVarViolations(termViolation, vioContainer);
+            continue;
+        }
+        auto reason = intVioContextTest->reason;
+        if (coefficients[i] < 0) {
+            reason = (reason == IntViolationContext::Reason::TOO_LARGE)
+                         ? IntViolationContext::Reason::TOO_SMALL
+                         : IntViolationContext::Reason::TOO_LARGE;
+        }
+        members[i]->updateVarViolations(
+            IntViolationContext(termViolation, reason), vioContainer);
+    }
+}
+
+void OpLinear::copy(OpLinear& newOp) const {
+    newOp.coefficients = coefficients;
+    newOp.constant = constant;
+    newOp.fuseWithOperand = fuseWithOperand;
+}
+
+std::ostream& OpLinear::dumpState(std::ostream& os) const {
+    os << "OpLinear: defined=" << this->appearsDefined()
+       << ", evaluationComplete=" << evaluationComplete
+       << ", fused=" << (fusedOperand != nullptr) << ", value=" << value
+       << ", constant=" << constant << ", coefficients=" << coefficients
+       << endl;
+    return operand->dumpState(os);
+}
+
+std::pair<bool, ExprRef<IntView>> OpLinear::optimiseImpl(ExprRef<IntView>& self,
+                                                         PathExtension path) {
+    auto boolOpPair = standardOptimise(self, path);
+    markFusion(*boolOpPair.second);
+    return boolOpPair;
+}
+
+string OpLinear::getOpName() const { return "OpLinear"; }
+
+void OpLinear::debugSanityCheckImpl() const {
+    operand->debugSanityCheck();
+    this->standardSanityDefinednessChecks();
+    auto& members = operand->view()->getMembers<IntView>();
+    sanityEqualsCheck(members.size(), coefficients.size());
+    if (!evaluationComplete) {
+        sanityCheck(!operand->getViewIfDefined(),
+                    "evaluation is not complete but operand is defined.");
+        return;
+    }
+    sanityCheckCachedValues(members.size());
+    Int checkValue = constant;
+    for (size_t i = 0; i < members.size(); i++) {
+        Int memberValue = getValueCatchUndef(members[i]);
+        Int cached = cachedValue(i);
+        sanityEqualsCheck(memberValue, cached);
+        checkValue += coefficients[i] * memberValue;
+    }
+    sanityEqualsCheck(checkValue, value);
+}
+
+static lib::optional<Int> getConstantValue(const ExprRef<IntView>& expr) {
+    if (!expr->isConstant()) {
+        return lib::nullopt;
+    }
+    expr->evaluate();
+    auto view = expr->getViewIfDefined();
+    return (view) ? lib::make_optional((*view).value) : lib::nullopt;
+}
+
+// expr as coefficient * term.  Negations and products with a single non
+// constant factor are split, term is null if expr is a product of constants.
+// Anything else is returned with a coefficient of 1.
+static pair<Int, ExprRef<IntView>> splitTerm(const ExprRef<IntView>& expr) {
+    auto negateTest = getAs<OpNegate>(expr);
+    if (negateTest) {
+        auto term = splitTerm(negateTest->operand);
+        term.first = -term.first;
+        return term;
+    }
+    auto prodTest = getAs<OpProd>(expr);
+    if (!prodTest) {
+        return make_pair(1, expr);
+    }
+    auto factorsTest = getAs<OpSequenceLit>(prodTest->operand);
+    if (!factorsTest) {
+        return make_pair(1, expr);
+    }
+    Int coefficient = 1;
+    ExprRef<IntView> term(nullptr);
+    for (auto& factor : factorsTest->getMembers<IntView>()) {
+        auto constantFactor = getConstantValue(factor);
+        if (constantFactor) {
+            coefficient *= *constantFactor;
+        } else if (!term) {
+            term = factor;
+        } else {
+            return make_pair(1, expr);
+        }
+    }
+    return make_pair(coefficient, term);
+}
+
+// true if expr is built from constants and the iterator of quantId alone.
+// Over a constant container, its value for each unrolled expr is then fixed.
+static bool builtFromIterator(const AnyExprRef& expr, UInt64 quantId) {
+    return lib::visit(
+        [&](auto& expr) {
+            typedef viewType(expr) View;
+            if (expr->isConstant()) {
+                return true;
+            }
+            auto iteratorTest = getAs<Iterator<View>>(expr);
+            if (iteratorTest) {
+                return iteratorTest->id == quantId;
+            }
+            if (getQuantifierContainer(expr)) {
+                return false;
+            }
+            bool hasOperands = false, builtFrom = true;
+            FindAndReplaceFunction findInOperand =
+                [&](AnyExprRef operand,
+                    const PathExtension&) -> pair<bool, AnyExprRef> {
+                hasOperands = true;
+                builtFrom &= builtFromIterator(operand, quantId);
+                return make_pair(true, operand);
+            };
+            expr->findAndReplaceSelf(findInOperand, PathExtension::begin());
+            // a non constant leaf is a variable
+            return hasOperands && builtFrom;
+        },
+        expr);
+}
+
+// if quant has a constant container, no condition and its expr is a product
+// in which all but one factor is built from the iterator, returns an OpLinear
+// over a copy of quant that unrolls the remaining factor.  The coefficient of
+// each unrolled expr is found now, by unrolling the other factors over the
+// same container.
+template <typename Quant>
+static lib::optional<ExprRef<IntView>> linearOverQuantifier(
+    const Quant& quant) {
+    if (!quant.container->isConstant() || quant.condition) {
+        return lib::nullopt;
+    }
+    auto exprTest = lib::get_if<ExprRef<IntView>>(&quant.expr);
+    if (!exprTest) {
+        return lib::nullopt;
+    }
+    auto prodTest = getAs<OpProd>(*exprTest);
+    if (!prodTest) {
+        return lib::nullopt;
+    }
+    auto factorsTest = getAs<OpSequenceLit>(prodTest->operand);
+    if (!factorsTest) {
+        return lib::nullopt;
+    }
+    ExprRefVec<IntView> coefficientFactors;
+    ExprRef<IntView> term(nullptr);
+    for (auto& factor : factorsTest->template getMembers<IntView>()) {
+        if (builtFromIterator(factor, quant.quantId)) {
+            coefficientFactors.emplace_back(factor);
+        } else if (!term) {
+            term = factor;
+        } else {
+            return lib::nullopt;
+        }
+    }
+    if (!term || coefficientFactors.empty()) {
+        return lib::nullopt;
+    }
+    auto coefficientQuant = make_shared<Quant>(quant);
+    coefficientQuant->setExpression(
+        (coefficientFactors.size() == 1)
+            ? coefficientFactors.front()
+            : OpMaker<OpProd>::make(
+                  OpMaker<OpSequenceLit>::make(move(coefficientFactors))));
+    coefficientQuant->evaluate();
+    if (!coefficientQuant->appearsDefined()) {
+        return lib::nullopt;
+    }
+    vector<Int> coefficients;
+    for (auto& coefficient : coefficientQuant->template getMembers<IntView>()) {
+        auto view = coefficient->getViewIfDefined();
+        if (!view) {
+            return lib::nullopt;
+        }
+        coefficients.push_back((*view).value);
+    }
+    debug_log("Optimise: sum of products over quantifier to OpLinear");
+    auto termQuant = make_shared<Quant>(quant);
+    termQuant->setExpression(move(term));
+    return OpMaker<OpLinear>::make(ExprRef<SequenceView>(termQuant),
+                                   move(coefficients), 0);
+}
+
+lib::optional<ExprRef<IntView>> optimiseSumToLinear(
+    const ExprRef<SequenceView>& sumOperand) {
+    auto quantifierTest = visitQuantifier<ExprRef<IntView>>(
+        sumOperand, [&](auto& quant) { return linearOverQuantifier(quant); });
+    if (quantifierTest) {
+        return quantifierTest;
+    }
+    auto sequenceLitTest = getAs<OpSequenceLit>(sumOperand);
+    if (!sequenceLitTest) {
+        return lib::nullopt;
+    }
+    bool split = false;
+    Int constant = 0;
+    vector<Int> coefficients;
+    ExprRefVec<IntView> terms;
+    for (auto& member : sequenceLitTest->getMembers<IntView>()) {
+        auto constantMember = getConstantValue(member);
+        if (constantMember) {
+            constant += *constantMember;
+            continue;
+        }
+        auto term = splitTerm(member);
+        if (!term.second) {
+            split = true;
+            constant += term.first;
+            continue;
+        }
+        split |= &(*term.second) != &(*member);
+        coefficients.push_back(term.first);
+        terms.emplace_back(move(term.second));
+    }
+    if (!split) {
+        return lib::nullopt;
+    }
+    debug_log("Optimise: sum of products with constants to OpLinear");
+    return OpMaker<OpLinear>::make(
+        OpMaker<OpSequenceLit>::make(move(terms)), move(coefficients),
+        constant);
+}
+
+ExprRef<IntView> OpMaker<OpLinear>::make(ExprRef<SequenceView> terms,
+                                         vector<Int> coefficients,
+                                         Int constant) {
+    auto op = make_shared<OpLinear>(move(terms));
+    op->coefficients = move(coefficients);
+    op->constant = constant;
+    op->fuseWithOperand = getAs<QuantifierBase>(op->operand).hasValue();
+    return op;
+}
+
+template struct SimpleUnaryOperator<IntView, SequenceView, OpLinear>;
+template struct FoldingOperator<IntView, OpLinear>;
@@ -0,0 +1,50 @@
+
+#ifndef SRC_OPERATORS_OPLINEAR_H_
+#define SRC_OPERATORS_OPLINEAR_H_
+#include <vector>
+
+#include "operators/foldingOperator.h"
+#include "types/int.h"
+#include "types/sequence.h"
+
+// constant plus the sum of coefficients[i] * operand[i].  The operand is a
+// sequence literal, or a quantifier over a constant container without a
+// condition, so its members are fixed.  Not parsed directly, the optimiser
+// produces it from a sum of products in which all but one factor is constant,
+// or for a quantifier, depends only on the iterator.
+struct OpLinear;
+template <>
+struct OperatorTrates<OpLinear> {
+    class OperandsSequenceTrigger;
+    typedef OperandsSequenceTrigger OperandTrigger;
+};
+
+struct OpLinear : public FoldingOperator<IntView, OpLinear> {
+    using FoldingOperator<IntView, OpLinear>::FoldingOperator;
+    std::vector<Int> coefficients;
+    Int constant = 0;
+    bool evaluationComplete = false;
+    OpLinear(OpLinear&&) = delete;
+    void reevaluateImpl(SequenceView& operandView);
+    // fold in the new value of the operand at index, returns the change to
+    // value.
+    Int foldInOperand(SequenceView& operandView, UInt index);
+    Int foldValueOf(UInt index) final;
+    void unrolledExprChanged(UInt index, Int& foldedValue) final;
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpLinear& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::pair<bool, ExprRef<IntView>> optimiseImpl(ExprRef<IntView>&,
+                                                   PathExtension path) final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+
+// if the members of the sequence literal sumOperand contain products with
+// constant factors, or sumOperand is a quantifier over such products, returns
+// an equivalent OpLinear to replace the sum.
+lib::optional<ExprRef<IntView>> optimiseSumToLinear(
+    const ExprRef<SequenceView>& sumOperand);
+
+#endif /* SRC_OPERATORS_OPLINEAR_H_ */
@@ -0,0 +1,144 @@
+#include "operators/opMSetFreq.h"
+
+#include <iostream>
+#include <memory>
+
+#include "operators/simpleOperator.hpp"
+#include "triggers/allTriggers.h"
+
+using namespace std;
+
+template <typename OperandView>
+void OpMSetFreq<OperandView>::reevaluateImpl(MSetView& mSetView,
+                                             OperandView& operandView, bool,
+                                             bool operandChanged) {
+    if (operandChanged) {
+        operandHash = getValueHash(operandView);
+    }
+    this->value = mSetView.memberCount(operandHash);
+}
+
+// as SimpleBinaryTrigger, which expects operands of the same type.
+template <typename OperandView>
+template <typename Derived, typename TriggerType, bool isLeft>
+struct OperatorTrates<OpMSetFreq<OperandView>>::OperandTriggerBase
+    : public ChangeTriggerAdapter<TriggerType, Derived> {
+    typedef typename AssociatedViewType<TriggerType>::type TriggeringView;
+    OpMSetFreq<OperandView>* op;
+    OperandTriggerBase(OpMSetFreq<OperandView>* op,
+                       const ExprRef<TriggeringView>& operand)
+        : ChangeTriggerAdapter<TriggerType, Derived>(operand), op(op) {}
+
+    inline void adapterValueChanged() {
+        bool wasDefined = op->isDefined();
+        op->changeValue([&]() {
+            op->reevaluate(isLeft, !isLeft);
+            return wasDefined && op->isDefined();
+        });
+        if (wasDefined && !op->isDefined()) {
+            op->notifyValueUndefined();
+        } else if (!wasDefined && op->isDefined()) {
+            op->notifyValueDefined();
+        }
+    }
+    void adapterHasBecomeUndefined() { op->setUndefinedAndTrigger(); }
+    void adapterHasBecomeDefined() {
+        if (op->left->appearsDefined() && op->right->appearsDefined()) {
+            op->reevaluateDefinedAndTrigger();
+        }
+    }
+};
+
+template <typename OperandView>
+struct OperatorTrates<OpMSetFreq<OperandView>>::LeftTrigger
+    : public OperandTriggerBase<LeftTrigger, MSetTrigger, true> {
+    LeftTrigger(OpMSetFreq<OperandView>* op)
+        : OperandTriggerBase<LeftTrigger, MSetTrigger, true>(op, op->left) {}
+    ExprRef<MSetView>& getTriggeringOperand() { return this->op->left; }
+    void reattachTrigger() final {
+        auto trigger = make_shared<LeftTrigger>(this->op);
+        this->op->left->addTrigger(trigger);
+        this->op->leftTrigger = trigger;
+    }
+};
+
+template <typename OperandView>
+struct OperatorTrates<OpMSetFreq<OperandView>>::RightTrigger
+    : public OperandTriggerBase<
+          RightTrigger, typename AssociatedTriggerType<OperandView>::type,
+          false> {
+    RightTrigger(OpMSetFreq<OperandView>* op)
+        : OperandTriggerBase<RightTrigger,
+                             typename AssociatedTriggerType<OperandView>::type,
+                             false>(op, op->right) {}
+    ExprRef<OperandView>& getTriggeringOperand() { return this->op->right; }
+    void reattachTrigger() final {
+        auto trigger = make_shared<RightTrigger>(this->op);
+        this->op->right->addTrigger(trigger);
+        this->op->rightTrigger = trigger;
+    }
+};
+
+template <typename OperandView>
+void OpMSetFreq<OperandView>::updateVarViolationsImpl(
+    const ViolationContext& vioContext, ViolationContainer& vioContainer) {
+    this->left->updateVarViolations(vioContext, vioContainer);
+    this->right->updateVarViolations(vioContext, vioContainer);
+}
+
+template <typename OperandView>
+void OpMSetFreq<OperandView>::copy(OpMSetFreq& newOp) const {
+    newOp.operandHash = operandHash;
+}
+
+template <typename OperandView>
+std::ostream& OpMSetFreq<OperandView>::dumpState(std::ostream& os) const {
+    os << "OpMSetFreq: value=" << this->getViewIfDefined() << "\nmSet: ";
+    this->left->dumpState(os);
+    os << "\noperand: ";
+    this->right->dumpState(os);
+    return os;
+}
+
+template <typename OperandView>
+string OpMSetFreq<OperandView>::getOpName() const {
+    return toString(
+        "OpMSetFreq<",
+        TypeAsString<typename AssociatedValueType<OperandView>::type>::value,
+        ">");
+}
+
+template <typename OperandView>
+void OpMSetFreq<OperandView>::debugSanityCheckImpl() const {
+    this->left->debugSanityCheck();
+    this->right->debugSanityCheck();
+    this->standardSanityDefinednessChecks();
+    auto mSetOption = this->left->getViewIfDefined();
+    auto operandOption = this->right->getViewIfDefined();
+    if (!mSetOption || !operandOption) {
+        return;
+    }
+    HashType checkHash = getValueHash(*operandOption);
+    sanityEqualsCheck(checkHash, operandHash);
+    sanityEqualsCheck((Int)mSetOption->memberCount(checkHash), this->value);
+}
+
+template <typename Op>
+struct OpMaker;
+template <typename OperandView>
+struct OpMaker<OpMSetFreq<OperandView>> {
+    static ExprRef<IntView> make(ExprRef<MSetView> mSet,
+                                 ExprRef<OperandView> operand);
+};
+template <typename OperandView>
+ExprRef<IntView> OpMaker<OpMSetFreq<OperandView>>::make(
+    ExprRef<MSetView> mSet, ExprRef<OperandView> operand) {
+    return make_shared<OpMSetFreq<OperandView>>(move(mSet), move(operand));
+}
+
+#define opMSetFreqInstantiators(name)       \
+    template struct OpMSetFreq<name##View>; \
+    template struct OpMaker<OpMSetFreq<name##View>>;
+
+buildForAllTypes(opMSetFreqInstantiators, );
+#undef opMSetFreqInstantiators
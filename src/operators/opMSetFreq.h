@@ -0,0 +1,36 @@
+
+#ifndef SRC_OPERATORS_OPMSETFREQ_H_
+#define SRC_OPERATORS_OPMSETFREQ_H_
+#include "operators/simpleOperator.h"
+#include "types/int.h"
+#include "types/mSet.h"
+// the number of times the right operand occurs in the left mset, read from
+// the mset's own member counts.  The hash of the right operand is cached, so
+// changes to the mset are O(1).
+template <typename OperandView>
+struct OpMSetFreq;
+template <typename OperandView>
+struct OperatorTrates<OpMSetFreq<OperandView>> {
+    template <typename Derived, typename TriggerType, bool isLeft>
+    struct OperandTriggerBase;
+    struct LeftTrigger;
+    struct RightTrigger;
+};
+
+template <typename OperandView>
+struct OpMSetFreq : public SimpleBinaryOperator<IntView, MSetView, OperandView,
+                                                OpMSetFreq<OperandView>> {
+    HashType operandHash = HashType(0);
+    using SimpleBinaryOperator<IntView, MSetView, OperandView,
+                               OpMSetFreq<OperandView>>::SimpleBinaryOperator;
+
+    void reevaluateImpl(MSetView& mSetView, OperandView& operandView, bool,
+                        bool operandChanged);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpMSetFreq& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+#endif /* SRC_OPERATORS_OPMSETFREQ_H_ */
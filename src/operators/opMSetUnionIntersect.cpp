@@ -0,0 +1,415 @@
+#include "operators/opMSetUnionIntersect.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include "operators/simpleOperator.hpp"
+#include "types/mSet.h"
+using namespace std;
+static const char* NO_UNDEFINED_IN_MSETUNIONINTERSECT =
+    "OpMSetUnion and OpMSetIntersect do not yet handle all the cases where "
+    "msets become undefined.  "
+    "Especially if returned views are undefined\n";
+
+namespace {
+HashType getHashForceDefined(const AnyExprRef& expr) {
+    return lib::visit(
+        [&](auto& expr) {
+            auto view = expr->getViewIfDefined();
+            if (!view) {
+                myCerr << NO_UNDEFINED_IN_MSETUNIONINTERSECT;
+                myAbort();
+            }
+            return getValueHash(*view);
+        },
+        expr);
+}
+
+template <bool isUnion>
+UInt targetCount(UInt leftCount, UInt rightCount) {
+    return (isUnion) ? max(leftCount, rightCount) : min(leftCount, rightCount);
+}
+}  // namespace
+
+template <bool isUnion>
+MSetView& OpMSetUnionIntersect<isUnion>::operandView(bool isLeft) {
+    auto view = (isLeft) ? this->left->getViewIfDefined()
+                         : this->right->getViewIfDefined();
+    return view.checkedGet(NO_UNDEFINED_IN_MSETUNIONINTERSECT);
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::insertEntry(bool isLeft, UInt index,
+                                                HashType hash, bool held) {
+    auto& operand = operandIndex(isLeft);
+    auto& entries = operand.hashEntries[hash];
+    operand.positions[index] = entries.indices.size();
+    entries.indices.emplace_back(index);
+    if (held) {
+        UInt firstUnheld = entries.indices[entries.numberHeld];
+        swap(entries.indices[entries.numberHeld], entries.indices.back());
+        swap(operand.positions[firstUnheld], operand.positions[index]);
+        ++entries.numberHeld;
+    }
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::removeEntry(bool isLeft, UInt index,
+                                                HashType hash) {
+    auto& operand = operandIndex(isLeft);
+    auto iter = operand.hashEntries.find(hash);
+    debug_code(assert(iter != operand.hashEntries.end()));
+    auto& entries = iter->second;
+    auto swapToPosition = [&](UInt position) {
+        UInt other = entries.indices[position];
+        swap(entries.indices[position],
+             entries.indices[operand.positions[index]]);
+        swap(operand.positions[other], operand.positions[index]);
+    };
+    if (operand.positions[index] < entries.numberHeld) {
+        --entries.numberHeld;
+        swapToPosition(entries.numberHeld);
+    }
+    swapToPosition(entries.indices.size() - 1);
+    entries.indices.pop_back();
+    if (entries.indices.empty()) {
+        operand.hashEntries.erase(iter);
+    }
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::moveEntry(bool isLeft, UInt from, UInt to,
+                                              HashType hash) {
+    auto& operand = operandIndex(isLeft);
+    operand.hashEntries[hash].indices[operand.positions[from]] = to;
+    operand.positions[to] = operand.positions[from];
+    operand.memberSlots[to] = operand.memberSlots[from];
+    if (operand.memberSlots[to] != -1) {
+        memberSources[operand.memberSlots[to]].second = to;
+    }
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::addOpMember(bool isLeft, UInt index,
+                                                bool notify) {
+    auto& view = operandView(isLeft);
+    operandIndex(isLeft).memberSlots[index] = memberSources.size();
+    memberSources.emplace_back(isLeft, index);
+    mpark::visit(
+        [&](auto& members) {
+            if (notify) {
+                this->addMemberAndNotify(members[index]);
+            } else {
+                this->addMember(members[index]);
+            }
+        },
+        view.members);
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::removeOpMember(UInt slot) {
+    auto source = memberSources[slot];
+    operandIndex(source.first).memberSlots[source.second] = -1;
+    memberSources[slot] = memberSources.back();
+    memberSources.pop_back();
+    if (slot < memberSources.size()) {
+        auto& moved = memberSources[slot];
+        operandIndex(moved.first).memberSlots[moved.second] = slot;
+    }
+    mpark::visit(
+        [&](auto& members) {
+            this->template removeMemberAndNotify<viewType(members)>(slot);
+        },
+        this->members);
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::updateCount(HashType hash, bool notify) {
+    UInt target = targetCount<isUnion>(operandView(true).memberCount(hash),
+                                       operandView(false).memberCount(hash));
+    UInt count = this->memberCount(hash);
+    while (count > target) {
+        auto& leftEntries = operandIndex(true).hashEntries;
+        auto iter = leftEntries.find(hash);
+        bool isLeft = iter != leftEntries.end() && iter->second.numberHeld > 0;
+        auto& entries = operandIndex(isLeft).hashEntries.at(hash);
+        UInt index = entries.indices[--entries.numberHeld];
+        removeOpMember(operandIndex(isLeft).memberSlots[index]);
+        --count;
+    }
+    while (count < target) {
+        auto& leftEntries = operandIndex(true).hashEntries;
+        auto iter = leftEntries.find(hash);
+        bool isLeft = iter != leftEntries.end() &&
+                      iter->second.numberHeld < iter->second.indices.size();
+        auto& entries = operandIndex(isLeft).hashEntries.at(hash);
+        UInt index = entries.indices[entries.numberHeld++];
+        addOpMember(isLeft, index, notify);
+        ++count;
+    }
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::reevaluateImpl(MSetView& leftView,
+                                                   MSetView& rightView, bool,
+                                                   bool) {
+    this->silentClear();
+    memberSources.clear();
+    mpark::visit(
+        [&](auto& leftMembers) {
+            this->members.template emplace<ExprRefVec<viewType(leftMembers)>>();
+        },
+        leftView.members);
+    for (bool isLeft : {true, false}) {
+        auto& view = (isLeft) ? leftView : rightView;
+        auto& operand = operandIndex(isLeft);
+        operand.hashEntries.clear();
+        operand.positions.assign(view.numberElements(), 0);
+        operand.memberSlots.assign(view.numberElements(), -1);
+        for (size_t i = 0; i < view.numberElements(); i++) {
+            insertEntry(isLeft, i, view.indexHashMap[i], false);
+        }
+    }
+    for (auto& hashCountPair : leftView.memberCounts) {
+        updateCount(hashCountPair.first, false);
+    }
+    if (isUnion) {
+        for (auto& hashCountPair : rightView.memberCounts) {
+            updateCount(hashCountPair.first, false);
+        }
+    }
+}
+
+template <bool isUnion>
+template <bool isLeft>
+struct OperatorTrates<OpMSetUnionIntersect<isUnion>>::OperandTrigger
+    : public MSetTrigger {
+    OpMSetUnionIntersect<isUnion>* op;
+    OperandTrigger(OpMSetUnionIntersect<isUnion>* op) : op(op) {}
+
+    void valueRemoved(UInt index, const AnyExprRef& member) final {
+        HashType hash = getHashForceDefined(member);
+        auto& operand = op->operandIndex(isLeft);
+        if (operand.memberSlots[index] != -1) {
+            op->removeOpMember(operand.memberSlots[index]);
+        }
+        op->removeEntry(isLeft, index, hash);
+        auto& view = op->operandView(isLeft);
+        UInt last = view.numberElements();
+        if (index < last) {
+            op->moveEntry(isLeft, last, index, view.indexHashMap[index]);
+        }
+        operand.positions.pop_back();
+        operand.memberSlots.pop_back();
+        op->updateCount(hash);
+    }
+
+    void valueAdded(const AnyExprRef& member) final {
+        HashType hash = getHashForceDefined(member);
+        auto& operand = op->operandIndex(isLeft);
+        UInt index = operand.positions.size();
+        operand.positions.emplace_back(0);
+        operand.memberSlots.emplace_back(-1);
+        op->insertEntry(isLeft, index, hash, false);
+        op->updateCount(hash);
+    }
+
+    inline void valueChanged() final {
+        op->reevaluate(true, true);
+        op->notifyEntireValueChanged();
+    }
+
+    void memberReplaced(UInt index, const AnyExprRef& oldMember) final {
+        HashType oldHash = getHashForceDefined(oldMember);
+        HashType newHash = op->operandView(isLeft).indexHashMap[index];
+        auto& operand = op->operandIndex(isLeft);
+        // this op holds the old member, the new one starts unheld.
+        if (operand.memberSlots[index] != -1) {
+            op->removeOpMember(operand.memberSlots[index]);
+        }
+        op->removeEntry(isLeft, index, oldHash);
+        op->insertEntry(isLeft, index, newHash, false);
+        op->updateCount(oldHash);
+        op->updateCount(newHash);
+    }
+
+    // move the entry of the changed member to its new hash, the counts are
+    // updated once all changed members have been moved.
+    void memberMoved(UInt index, HashType oldHash) {
+        auto& operand = op->operandIndex(isLeft);
+        Int slot = operand.memberSlots[index];
+        HashType newHash = op->operandView(isLeft).indexHashMap[index];
+        if (oldHash != newHash) {
+            op->removeEntry(isLeft, index, oldHash);
+            op->insertEntry(isLeft, index, newHash, slot != -1);
+        }
+        if (slot != -1) {
+            mpark::visit(
+                [&](auto& members) {
+                    op->template memberChangedAndNotify<viewType(members)>(
+                        slot);
+                },
+                op->members);
+        }
+    }
+
+    inline void memberValueChanged(UInt index, HashType oldHash) final {
+        memberMoved(index, oldHash);
+        op->updateCount(oldHash);
+        op->updateCount(op->operandView(isLeft).indexHashMap[index]);
+    }
+
+    inline void memberValuesChanged(
+        const std::vector<UInt>& indices,
+        const std::vector<HashType>& oldHashes) final {
+        for (size_t i = 0; i < indices.size(); i++) {
+            memberMoved(indices[i], oldHashes[i]);
+        }
+        for (HashType hash : oldHashes) {
+            op->updateCount(hash);
+        }
+        auto& view = op->operandView(isLeft);
+        for (auto index : indices) {
+            op->updateCount(view.indexHashMap[index]);
+        }
+    }
+
+    void reattachTrigger() final {
+        if (isLeft) {
+            reattachLeftTrigger();
+        } else {
+            reattachRightTrigger();
+        }
+    }
+    void reattachLeftTrigger() {
+        auto trigger = make_shared<OperandTrigger<true>>(op);
+        op->left->addTrigger(trigger);
+        op->leftTrigger = trigger;
+    }
+    void reattachRightTrigger() {
+        auto trigger = make_shared<OperandTrigger<false>>(op);
+        op->right->addTrigger(trigger);
+        op->rightTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { todoImpl(); }
+    void hasBecomeDefined() final { todoImpl(); }
+};
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::updateVarViolationsImpl(
+    const ViolationContext& vioContext, ViolationContainer& vioContainer) {
+    this->left->updateVarViolations(vioContext, vioContainer);
+    this->right->updateVarViolations(vioContext, vioContainer);
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::copy(OpMSetUnionIntersect&) const {}
+
+template <bool isUnion>
+std::ostream& OpMSetUnionIntersect<isUnion>::dumpState(
+    std::ostream& os) const {
+    os << getOpName() << ": value=" << this->getViewIfDefined()
+       << "\nLeft: ";
+    this->left->dumpState(os);
+    os << "\nRight: ";
+    this->right->dumpState(os);
+    return os;
+}
+
+template <bool isUnion>
+string OpMSetUnionIntersect<isUnion>::getOpName() const {
+    return (isUnion) ? "OpMSetUnion" : "OpMSetIntersect";
+}
+
+template <bool isUnion>
+void OpMSetUnionIntersect<isUnion>::debugSanityCheckImpl() const {
+    this->left->debugSanityCheck();
+    this->right->debugSanityCheck();
+    auto leftOption = this->left->getViewIfDefined();
+    auto rightOption = this->right->getViewIfDefined();
+    if (!leftOption || !rightOption) {
+        todoImpl();
+        return;
+    }
+    auto& leftView = *leftOption;
+    auto& rightView = *rightOption;
+    this->standardSanityChecksForThisType();
+    UInt checkSize = 0;
+    auto checkCount = [&](HashType hash) {
+        UInt target = targetCount<isUnion>(leftView.memberCount(hash),
+                                           rightView.memberCount(hash));
+        auto iter = this->memberCounts.find(hash);
+        UInt count = (iter != this->memberCounts.end()) ? iter->second : 0;
+        sanityEqualsCheck(target, count);
+        checkSize += target;
+    };
+    for (auto& hashCountPair : leftView.memberCounts) {
+        checkCount(hashCountPair.first);
+    }
+    for (auto& hashCountPair : rightView.memberCounts) {
+        if (!leftView.memberCounts.count(hashCountPair.first)) {
+            checkCount(hashCountPair.first);
+        }
+    }
+    sanityEqualsCheck(checkSize, this->numberElements());
+    sanityEqualsCheck(this->numberElements(), memberSources.size());
+    mpark::visit(
+        [&](auto& opMembers) {
+            typedef viewType(opMembers) InnerViewType;
+            for (size_t i = 0; i < opMembers.size(); i++) {
+                auto& source = memberSources[i];
+                auto& view = (source.first) ? leftView : rightView;
+                auto& operand = operandIndices[(source.first) ? 0 : 1];
+                sanityCheck(source.second < view.numberElements(),
+                            "member source out of range.");
+                sanityCheck(&(*view.template getMembers<InnerViewType>()
+                                   [source.second]) == &(*opMembers[i]),
+                            toString("member ", i,
+                                     " is not the operand member it was "
+                                     "taken from."));
+                sanityEqualsCheck((Int)i, operand.memberSlots[source.second]);
+            }
+        },
+        this->members);
+    for (bool isLeft : {true, false}) {
+        auto& view = (isLeft) ? leftView : rightView;
+        auto& operand = operandIndices[(isLeft) ? 0 : 1];
+        sanityEqualsCheck(view.numberElements(), operand.positions.size());
+        sanityEqualsCheck(view.numberElements(), operand.memberSlots.size());
+        for (size_t i = 0; i < view.numberElements(); i++) {
+            auto iter = operand.hashEntries.find(view.indexHashMap[i]);
+            sanityCheck(iter != operand.hashEntries.end(),
+                        toString("no entries for operand member ", i));
+            auto& entries = iter->second;
+            UInt position = operand.positions[i];
+            sanityCheck(position < entries.indices.size() &&
+                            entries.indices[position] == i,
+                        toString("operand member ", i,
+                                 " is not at its position."));
+            bool held = position < entries.numberHeld;
+            bool hasSlot = operand.memberSlots[i] != -1;
+            sanityEqualsCheck(held, hasSlot);
+        }
+    }
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <bool isUnion>
+struct OpMaker<OpMSetUnionIntersect<isUnion>> {
+    static ExprRef<MSetView> make(ExprRef<MSetView> l, ExprRef<MSetView> r);
+};
+
+template <bool isUnion>
+ExprRef<MSetView> OpMaker<OpMSetUnionIntersect<isUnion>>::make(
+    ExprRef<MSetView> l, ExprRef<MSetView> r) {
+    return make_shared<OpMSetUnionIntersect<isUnion>>(move(l), move(r));
+}
+
+template struct OpMSetUnionIntersect<true>;
+template struct OpMaker<OpMSetUnionIntersect<true>>;
+template struct OpMSetUnionIntersect<false>;
+template struct OpMaker<OpMSetUnionIntersect<false>>;
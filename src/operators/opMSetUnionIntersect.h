@@ -0,0 +1,72 @@
+
+#ifndef SRC_OPERATORS_OPMSETUNIONINTERSECT_H_
+#define SRC_OPERATORS_OPMSETUNIONINTERSECT_H_
+#include <array>
+#include <vector>
+
+#include "operators/simpleOperator.h"
+#include "types/mSet.h"
+// union or intersection of two msets, each value occurring the max or min of
+// the number of times it occurs in left and right.  The members of this op
+// are members of the operands, so for each operand the members of each hash
+// are indexed, those held by this op first.  Adding, removing or changing an
+// operand member then updates the counts of the hashes involved in O(1).
+template <bool isUnion>
+struct OpMSetUnionIntersect;
+template <bool isUnion>
+struct OperatorTrates<OpMSetUnionIntersect<isUnion>> {
+    template <bool isLeft>
+    struct OperandTrigger;
+    typedef OperandTrigger<true> LeftTrigger;
+    typedef OperandTrigger<false> RightTrigger;
+};
+template <bool isUnion>
+struct OpMSetUnionIntersect
+    : public SimpleBinaryOperator<MSetView, MSetView, MSetView,
+                                  OpMSetUnionIntersect<isUnion>> {
+    // the indices of the operand members with one hash, the first
+    // numberHeld of them are members of this op.
+    struct HashEntries {
+        std::vector<UInt> indices;
+        UInt numberHeld = 0;
+    };
+    struct OperandIndex {
+        HashMap<HashType, HashEntries> hashEntries;
+        // the position of each operand member in its hash entries.
+        std::vector<UInt> positions;
+        // the member of this op holding each operand member, -1 if none.
+        std::vector<Int> memberSlots;
+    };
+    std::array<OperandIndex, 2> operandIndices;
+    // for each member of this op, the operand and index it was taken from.
+    std::vector<std::pair<bool, UInt>> memberSources;
+
+    using SimpleBinaryOperator<
+        MSetView, MSetView, MSetView,
+        OpMSetUnionIntersect<isUnion>>::SimpleBinaryOperator;
+
+    inline OperandIndex& operandIndex(bool isLeft) {
+        return operandIndices[(isLeft) ? 0 : 1];
+    }
+    MSetView& operandView(bool isLeft);
+    void insertEntry(bool isLeft, UInt index, HashType hash, bool held);
+    void removeEntry(bool isLeft, UInt index, HashType hash);
+    // the operand member at index from has been moved to index to.
+    void moveEntry(bool isLeft, UInt from, UInt to, HashType hash);
+    void addOpMember(bool isLeft, UInt index, bool notify);
+    void removeOpMember(UInt slot);
+    // add or remove members with the given hash until this op holds it as
+    // many times as the operands say it should.
+    void updateCount(HashType hash, bool notify = true);
+
+    void reevaluateImpl(MSetView& leftView, MSetView& rightView, bool, bool);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpMSetUnionIntersect& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+typedef OpMSetUnionIntersect<true> OpMSetUnion;
+typedef OpMSetUnionIntersect<false> OpMSetIntersect;
+#endif /* SRC_OPERATORS_OPMSETUNIONINTERSECT_H_ */
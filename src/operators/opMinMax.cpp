@@ -4,7 +4,6 @@
 #include <cassert>
 
 #include "operators/flatten.h"
-#include "operators/shiftViolatingIndices.h"
 #include "operators/simpleOperator.hpp"
 #include "types/sequenceVal.h"
 #include "utils/ignoreUnused.h"
@@ -15,123 +14,72 @@ template <bool minMode>
 using OperandsSequenceTrigger =
     typename OperatorTrates<OpMinMax<minMode>>::OperandsSequenceTrigger;
 
-template <bool minMode>
-void updateMinValues(OpMinMax<minMode>& op, bool trigger);
-
-template <bool minMode>
-bool OpMinMax<minMode>::compare(Int u, Int v) {
-    return (minMode) ? u < v : v < u;
+static inline lib::optional<Int> getValueIfDefined(
+    const ExprRef<IntView>& expr) {
+    auto view = expr->getViewIfDefined();
+    return (view) ? lib::make_optional((*view).value) : lib::nullopt;
 }
 
 template <bool minMode>
-void OpMinMax<minMode>::reevaluateImpl(SequenceView&) {
-    minValueIndices.clear();
-    this->setDefined(true);
-    updateMinValues(*this, false);
-}
-template <bool minMode>
-void triggerChange(OpMinMax<minMode>& op, bool wasDefined, Int oldValue) {
-    if (!wasDefined && !op.isDefined()) {
-        op.notifyValueDefined();
-    } else if (wasDefined && !op.isDefined()) {
-        op.notifyValueUndefined();
-    } else if (op.isDefined()) {
-        swap(op.value, oldValue);
-        op.changeValue([&]() {
-            swap(op.value, oldValue);
-            return true;
-        });
+void OpMinMax<minMode>::countValue(const lib::optional<Int>& operandValue) {
+    if (operandValue) {
+        ++valueCounts[*operandValue];
     }
 }
 
 template <bool minMode>
-inline void updateMinValues(OpMinMax<minMode>& op, bool trigger) {
-    bool wasDefined = op.isDefined();
-
-    auto operandView = op.operand->getViewIfDefined();
-    if (!operandView) {
-        op.setDefined(false);
-        triggerChange(op, wasDefined, op.value);
+void OpMinMax<minMode>::uncountValue(const lib::optional<Int>& operandValue) {
+    if (!operandValue) {
         return;
     }
-    auto& members = (*operandView).template getMembers<IntView>();
-    bool foundUndefined = false;
-    Int oldValue = op.value;
-    for (size_t i = 0; i < members.size(); ++i) {
-        auto& operandChild = members[i];
-        auto operandChildView = operandChild->getViewIfDefined();
-        if (!operandChildView) {
-            foundUndefined = true;
-            continue;
-        }
-        Int operandValue = operandChildView->value;
-        if (op.minValueIndices.empty() || op.compare(operandValue, op.value)) {
-            op.value = operandValue;
-            op.minValueIndices.clear();
-            op.minValueIndices.insert(i);
-        } else if (operandValue == op.value) {
-            op.minValueIndices.insert(i);
-        }
-    }
-    op.setDefined(!foundUndefined && !op.minValueIndices.empty());
-    if (trigger) {
-        triggerChange(op, wasDefined, oldValue);
+    auto iter = valueCounts.find(*operandValue);
+    debug_code(assert(iter != valueCounts.end()));
+    if (--iter->second == 0) {
+        valueCounts.erase(iter);
     }
 }
 
-// returns true if the function did a full revaluate of the OpMinMax node
 template <bool minMode>
-inline bool handleOperandValueChange(OpMinMax<minMode>& op, Int index) {
-    const ExprRef<IntView> expr =
-        op.operand->view()->template getMembers<IntView>()[index];
-    auto exprView = expr->view();
-    if (!exprView) {
-        op.handleMemberUndefined(index);
-        return false;
-    }
-    bool fullReevaluate = false;
-    if (op.compare((*exprView).value, op.value)) {
-        op.value = (*exprView).value;
-        op.minValueIndices.clear();
-        op.minValueIndices.insert(index);
-    } else if ((*exprView).value == op.value) {
-        op.minValueIndices.insert(index);
-    } else {
-        // otherwise value is greater, needs to be removed
-        op.minValueIndices.erase(index);
-        if (op.minValueIndices.size() == 0) {
-            // new min needs to be found
-            fullReevaluate = true;
-            op.reevaluate();
-        }
+void setValueFromCounts(OpMinMax<minMode>& op) {
+    if (op.valueCounts.empty()) {
+        op.setDefined(false);
+        return;
     }
-    return fullReevaluate;
+    op.value = (minMode) ? op.valueCounts.begin()->first
+                         : op.valueCounts.rbegin()->first;
+    op.setDefined(op.operand->appearsDefined());
 }
+
 template <bool minMode>
-void OpMinMax<minMode>::handleMemberUndefined(UInt index) {
-    this->setUndefinedAndTrigger();
-    if (minValueIndices.count(index)) {
-        minValueIndices.erase(index);
-    }
-    if (minValueIndices.empty()) {
-        updateMinValues(*this, true);
+void OpMinMax<minMode>::reevaluateImpl(SequenceView& operandView) {
+    valueCounts.clear();
+    cachedValues.clear();
+    auto& members = operandView.getMembers<IntView>();
+    for (size_t i = 0; i < members.size(); i++) {
+        auto operandValue = getValueIfDefined(members[i]);
+        countValue(operandValue);
+        cachedValues.insert(i, operandValue);
     }
+    evaluationComplete = true;
+    setValueFromCounts(*this);
 }
+
 template <bool minMode>
-void OpMinMax<minMode>::handleMemberDefined(UInt index) {
-    auto& expr = this->operand->view()->template getMembers<IntView>()[index];
-    auto exprView = expr->getViewIfDefined();
-    if (!exprView) {
-        return;
-    }
-    if (minValueIndices.empty() || compare((*exprView).value, this->value)) {
-        minValueIndices.clear();
-        minValueIndices.insert(index);
-        this->value = (*exprView).value;
-    } else if ((*exprView).value == this->value) {
-        minValueIndices.insert(index);
+void OpMinMax<minMode>::updateValueAndTrigger() {
+    bool wasDefined = this->isDefined();
+    Int oldValue = this->value;
+    setValueFromCounts(*this);
+    if (!wasDefined && this->isDefined()) {
+        this->notifyValueDefined();
+    } else if (wasDefined && !this->isDefined()) {
+        this->notifyValueUndefined();
+    } else if (this->isDefined() && this->value != oldValue) {
+        swap(this->value, oldValue);
+        this->changeValue([&]() {
+            swap(this->value, oldValue);
+            return true;
+        });
     }
-    this->setDefined(this->operand->appearsDefined());
 }
 
 template <bool minMode>
@@ -140,90 +88,67 @@ class OperatorTrates<OpMinMax<minMode>>::OperandsSequenceTrigger
    public:
     OpMinMax<minMode>* op;
     OperandsSequenceTrigger(OpMinMax<minMode>* op) : op(op) {}
-    void setNewValue(Int value) {
-        if (!op->isDefined()) {
-            op->value = value;
-            op->setDefined(op->operand->appearsDefined());
-            if (op->isDefined()) {
-                op->notifyValueDefined();
-            }
-        } else {
-            op->changeValue([&]() {
-                op->value = value;
-                return true;
-            });
-        }
-    }
 
     void valueAdded(UInt index, const AnyExprRef& exprIn) final {
-        auto& expr = lib::get<ExprRef<IntView>>(exprIn);
-        auto view = expr->getViewIfDefined();
-
-        // if is better
-        if (view && (op->minValueIndices.empty() ||
-                     op->compare((*view).value, op->value))) {
-            op->minValueIndices.clear();
-            op->minValueIndices.insert(index);
-            setNewValue((*view).value);
-            // if is equal
-        } else if (view && (*view).value == op->value) {
-            // need to add this index to set of min value indices.
-            // must shift other indices up
-            shiftIndicesUp(index, op->operand->view()->numberElements(),
-                           op->minValueIndices);
-            op->minValueIndices.insert(index);
-            // if is worse
-        } else if (!op->minValueIndices.empty()) {
-            // it is ignored, still need to shift indices
-            shiftIndicesUp(index, op->operand->view()->numberElements(),
-                           op->minValueIndices);
+        if (!op->evaluationComplete) {
             return;
         }
+        auto operandValue =
+            getValueIfDefined(lib::get<ExprRef<IntView>>(exprIn));
+        op->countValue(operandValue);
+        op->cachedValues.insert(index, operandValue);
+        op->updateValueAndTrigger();
     }
 
     void valueRemoved(UInt index, const AnyExprRef&) final {
-        if (op->minValueIndices.count(index)) {
-            op->minValueIndices.erase(index);
-        }
-        if (!op->minValueIndices.empty()) {
-            shiftIndicesDown(index, op->operand->view()->numberElements(),
-                             op->minValueIndices);
-        } else {
-            updateMinValues(*op, true);
+        if (!op->evaluationComplete) {
+            if (op->operand->getViewIfDefined()) {
+                op->reevaluateDefinedAndTrigger();
+            }
+            return;
         }
+        op->uncountValue(op->cachedValues.erase(index));
+        op->updateValueAndTrigger();
     }
 
     inline void positionsSwapped(UInt index1, UInt index2) {
-        if (op->minValueIndices.count(index1)) {
-            if (!op->minValueIndices.count(index2)) {
-                op->minValueIndices.erase(index1);
-                op->minValueIndices.insert(index2);
-            }
-        } else {
-            if (op->minValueIndices.count(index2)) {
-                op->minValueIndices.erase(index2);
-                op->minValueIndices.insert(index1);
-            }
+        if (!op->evaluationComplete) {
+            return;
         }
+        op->cachedValues.swap(index1, index2);
     }
     void memberReplaced(UInt index, const AnyExprRef&) {
         subsequenceChanged(index, index + 1);
     }
     inline void subsequenceChanged(UInt startIndex, UInt endIndex) final {
-        op->changeValue([&]() {
-            for (size_t i = startIndex; i < endIndex; i++) {
-                bool fullReevaluated = handleOperandValueChange(*op, i);
-                if (fullReevaluated) {
-                    break;
-                }
-            }
-            return op->isDefined();
-        });
+        if (!op->evaluationComplete) {
+            return;
+        }
+        auto& members = op->operand->view()->template getMembers<IntView>();
+        for (size_t i = startIndex; i < endIndex; i++) {
+            auto operandValue = getValueIfDefined(members[i]);
+            op->countValue(operandValue);
+            op->uncountValue(op->cachedValues.getAndSet(i, operandValue));
+        }
+        op->updateValueAndTrigger();
     }
 
     void valueChanged() final {
-        op->minValueIndices.clear();
-        updateMinValues(*op, true);
+        bool wasDefined = op->isDefined();
+        Int oldValue = op->value;
+        op->evaluationComplete = false;
+        op->reevaluate();
+        if (!wasDefined && op->isDefined()) {
+            op->notifyValueDefined();
+        } else if (wasDefined && !op->isDefined()) {
+            op->notifyValueUndefined();
+        } else if (op->isDefined() && op->value != oldValue) {
+            swap(op->value, oldValue);
+            op->changeValue([&]() {
+                swap(op->value, oldValue);
+                return true;
+            });
+        }
     }
     void reattachTrigger() final {
         auto trigger = make_shared<
@@ -231,14 +156,31 @@ class OperatorTrates<OpMinMax<minMode>>::OperandsSequenceTrigger
         op->operand->addTrigger(trigger);
         op->operandTrigger = trigger;
     }
-    void hasBecomeUndefined() final { op->setUndefinedAndTrigger(); }
+    void hasBecomeUndefined() final {
+        op->setUndefinedAndTrigger();
+        op->evaluationComplete = false;
+    }
     void hasBecomeDefined() final { op->reevaluateDefinedAndTrigger(); }
     void memberHasBecomeUndefined(UInt index) final {
-        op->handleMemberUndefined(index);
+        if (!op->evaluationComplete) {
+            return;
+        }
+        op->uncountValue(op->cachedValues.getAndSet(index, lib::nullopt));
+        op->updateValueAndTrigger();
     }
 
     void memberHasBecomeDefined(UInt index) final {
-        op->handleMemberDefined(index);
+        if (!op->evaluationComplete) {
+            if (op->operand->getViewIfDefined()) {
+                op->reevaluateDefinedAndTrigger();
+            }
+            return;
+        }
+        auto operandValue = getValueIfDefined(
+            op->operand->view()->template getMembers<IntView>()[index]);
+        op->countValue(operandValue);
+        op->cachedValues.getAndSet(index, operandValue);
+        op->updateValueAndTrigger();
     }
 };
 
@@ -258,15 +200,13 @@ void OpMinMax<minMode>::updateVarViolationsImpl(
 template <bool minMode>
 void OpMinMax<minMode>::copy(OpMinMax<minMode>& newOp) const {
     newOp.value = this->value;
-    newOp.minValueIndices = minValueIndices;
 }
 template <bool minMode>
 std::ostream& OpMinMax<minMode>::dumpState(std::ostream& os) const {
     os << "OpMinMax: " << ((minMode) ? "minimising" : "maximising")
-       << "value=" << this->value << endl;
-    vector<Int> sortedOperands(minValueIndices.begin(), minValueIndices.end());
-    sort(sortedOperands.begin(), sortedOperands.end());
-    os << "Min ValuessIndices: " << sortedOperands << endl;
+       << ", value=" << this->value
+       << ", evaluationComplete=" << evaluationComplete
+       << ", numberDistinctValues=" << valueCounts.size() << endl;
     return this->operand->dumpState(os);
 }
 
@@ -291,37 +231,36 @@ void OpMinMax<minMode>::debugSanityCheckImpl() const {
                     "operator must be undefined as operand is undefined.");
         return;
     }
+    if (!evaluationComplete) {
+        sanityCheck(!this->operand->getViewIfDefined(),
+                    "evaluation is not complete but operand is defined.");
+        sanityCheck(!this->appearsDefined(),
+                    "evaluation is not complete but operator is defined.");
+        return;
+    }
     auto& members = (*operandView).template getMembers<IntView>();
-    FastIterableIntSet checkMinValueIndices(0, 0);
-    Int checkValue;
+    sanityEqualsCheck(members.size(), cachedValues.size());
+    map<Int, UInt> checkValueCounts;
     for (size_t i = 0; i < members.size(); ++i) {
-        auto& operandChild = members[i];
-        auto operandChildView = operandChild->getViewIfDefined();
-        if (!operandChildView) {
-            continue;
+        auto operandValue = getValueIfDefined(members[i]);
+        sanityEqualsCheck(operandValue.has_value(),
+                          cachedValues.get(i).has_value());
+        if (operandValue) {
+            sanityEqualsCheck(*operandValue, *cachedValues.get(i));
+            ++checkValueCounts[*operandValue];
         }
-        Int operandValue = operandChildView->value;
-        if (checkMinValueIndices.empty() || compare(operandValue, checkValue)) {
-            checkValue = operandValue;
-            checkMinValueIndices.clear();
-            checkMinValueIndices.insert(i);
-        } else if (operandValue == checkValue) {
-            checkMinValueIndices.insert(i);
-        }
-    }
-    sanityEqualsCheck(checkMinValueIndices.size(), minValueIndices.size());
-    for (const auto& index : checkMinValueIndices) {
-        sanityCheck(
-            minValueIndices.count(index),
-            toString("index ", index, " is missing from minValueIndices."));
     }
-    if (!checkMinValueIndices.empty()) {
-        sanityEqualsCheck(checkValue, this->value);
-        sanityCheck(this->appearsDefined(), "operator must be defined.");
-    } else {
+    sanityCheck(checkValueCounts == valueCounts,
+                "valueCounts does not match the operands.");
+    if (checkValueCounts.empty()) {
         sanityCheck(!this->appearsDefined(),
                     "empty min/max means this operator should be undefined.");
+        return;
     }
+    Int checkValue = (minMode) ? checkValueCounts.begin()->first
+                               : checkValueCounts.rbegin()->first;
+    sanityEqualsCheck(checkValue, this->value);
+    sanityEqualsCheck(this->operand->appearsDefined(), this->appearsDefined());
 }
 
 template <typename Op>
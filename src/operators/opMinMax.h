@@ -1,12 +1,13 @@
 
-#ifndef SRC_OPERATORS_OPOR_H_
-#define SRC_OPERATORS_OPOR_H_
+#ifndef SRC_OPERATORS_OPMINMAX_H_
+#define SRC_OPERATORS_OPMINMAX_H_
+#include <map>
 #include <vector>
 
+#include "operators/previousValueCache.h"
 #include "operators/simpleOperator.h"
 #include "types/int.h"
 #include "types/sequence.h"
-#include "utils/fastIterableIntSet.h"
 template <bool minMode>
 struct OpMinMax;
 template <bool minMode>
@@ -20,17 +21,25 @@ struct OpMinMax
     : public SimpleUnaryOperator<IntView, SequenceView, OpMinMax<minMode>> {
     using SimpleUnaryOperator<IntView, SequenceView,
                               OpMinMax<minMode>>::SimpleUnaryOperator;
-    FastIterableIntSet minValueIndices = FastIterableIntSet(0, 0);
+    bool evaluationComplete = false;
+    // the number of defined operands holding each value.  The extremum is
+    // at one end, so finding the next one after it is removed is O(log n).
+    std::map<Int, UInt> valueCounts;
+    // the value of each operand as counted in valueCounts, nullopt whilst
+    // the operand is undefined.
+    PreviousValueCache<lib::optional<Int>> cachedValues;
 
     void reevaluateImpl(SequenceView& sequenceView);
+    void countValue(const lib::optional<Int>& operandValue);
+    void uncountValue(const lib::optional<Int>& operandValue);
+    // set value and definedness from valueCounts and notify parents of any
+    // change.
+    void updateValueAndTrigger();
     void updateVarViolationsImpl(const ViolationContext& vioContext,
                                  ViolationContainer& vioContainer) final;
     void copy(OpMinMax& newOp) const;
     std::ostream& dumpState(std::ostream& os) const final;
 
-    static bool compare(Int u, Int v);
-    void handleMemberUndefined(UInt);
-    void handleMemberDefined(UInt);
 
     std::string getOpName() const final;
     void debugSanityCheckImpl() const final;
@@ -39,4 +48,4 @@ struct OpMinMax
 };
 typedef OpMinMax<true> OpMin;
 typedef OpMinMax<false> OpMax;
-#endif /* SRC_OPERATORS_OPOR_H_ */
+#endif /* SRC_OPERATORS_OPMINMAX_H_ */
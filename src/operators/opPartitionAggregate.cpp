@@ -0,0 +1,358 @@
+#include "operators/opPartitionAggregate.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "operators/iterator.h"
+#include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+
+static const char* NO_PARTITION_WEIGHT_UNDEFINED =
+    "Not currently supporting partition aggregates over undefined weights.\n";
+
+template <PartitionAggregate aggregate>
+template <typename View>
+Int OpPartitionAggregate<aggregate>::weigh(const ExprRef<View>& member) {
+    HashType hash = getValueHash(member);
+    auto cachedTest = termCache->find(hash);
+    if (cachedTest != termCache->end()) {
+        return cachedTest->second;
+    }
+    auto iterator = make_shared<Iterator<View>>(termIterId, nullptr);
+    auto weightExpr = term->deepCopyForUnroll(term, AnyIterRef(iterator));
+    // copying sets the iterator to the value of the template's iterator.
+    iterator->changeValue(member);
+    weightExpr->evaluate();
+    Int weight = weightExpr->getViewIfDefined()
+                     .checkedGet(NO_PARTITION_WEIGHT_UNDEFINED)
+                     .value;
+    termCache->emplace(hash, weight);
+    return weight;
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::addWeight(UInt part, Int weight) {
+    if (aggregate == PartitionAggregate::SUM) {
+        partTotals[part] += weight;
+    } else {
+        ++partWeightCounts[part][weight];
+    }
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::removeWeight(UInt part, Int weight) {
+    if (aggregate == PartitionAggregate::SUM) {
+        partTotals[part] -= weight;
+        return;
+    }
+    auto& counts = partWeightCounts[part];
+    auto countTest = counts.find(weight);
+    debug_code(assert(countTest != counts.end()));
+    if (--countTest->second == 0) {
+        counts.erase(countTest);
+    }
+}
+
+template <PartitionAggregate aggregate>
+Int OpPartitionAggregate<aggregate>::calcPartValue(UInt part) const {
+    switch (aggregate) {
+        case PartitionAggregate::SUM:
+            return partTotals[part];
+        case PartitionAggregate::MIN:
+            return partWeightCounts[part].begin()->first;
+        case PartitionAggregate::MAX:
+            return partWeightCounts[part].rbegin()->first;
+    }
+    shouldNotBeCalledPanic;
+}
+
+template <PartitionAggregate aggregate>
+ExprRef<IntView> OpPartitionAggregate<aggregate>::makePartValue(UInt part) {
+    auto member = make_shared<PartValue>(this, part);
+    member->value = calcPartValue(part);
+    member->setEvaluated(true);
+    member->setAppearsDefined(true);
+    return ExprRef<IntView>(member);
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::addSlotAndNotify(UInt part) {
+    UInt slot = this->numberElements();
+    partSlotMap[part] = slot;
+    slotPartMap.emplace_back(part);
+    this->addMemberAndNotify(slot, makePartValue(part));
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::removeSlotAndNotify(UInt part) {
+    // swap the part's slot to the end so that no other slot moves.
+    UInt slot = partSlotMap[part];
+    UInt lastSlot = this->numberElements() - 1;
+    if (slot != lastSlot) {
+        this->template swapAndNotify<IntView>(slot, lastSlot);
+        slotPartMap[slot] = slotPartMap[lastSlot];
+        partSlotMap[slotPartMap[slot]] = slot;
+    }
+    slotPartMap.pop_back();
+    partSlotMap[part] = -1;
+    this->template removeMemberAndNotify<IntView>(lastSlot);
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::membersMoved(
+    const vector<UInt>& memberIndices, const vector<UInt>& oldParts) {
+    auto& operandView = *this->operand->view();
+    vector<UInt> changedParts;
+    for (size_t i = 0; i < memberIndices.size(); i++) {
+        UInt memberIndex = memberIndices[i];
+        UInt newPart = operandView.memberPartMap[memberIndex];
+        if (oldParts[i] == newPart) {
+            continue;
+        }
+        removeWeight(oldParts[i], memberWeights[memberIndex]);
+        addWeight(newPart, memberWeights[memberIndex]);
+        changedParts.emplace_back(oldParts[i]);
+        changedParts.emplace_back(newPart);
+    }
+    sort(changedParts.begin(), changedParts.end());
+    changedParts.erase(unique(changedParts.begin(), changedParts.end()),
+                       changedParts.end());
+    for (UInt part : changedParts) {
+        if (operandView.partInfo[part].partSize == 0 &&
+            partSlotMap[part] != -1) {
+            removeSlotAndNotify(part);
+        }
+    }
+    auto& members = this->template getMembers<IntView>();
+    for (UInt part : changedParts) {
+        if (operandView.partInfo[part].partSize == 0) {
+            continue;
+        }
+        if (partSlotMap[part] == -1) {
+            addSlotAndNotify(part);
+            continue;
+        }
+        UInt slot = partSlotMap[part];
+        auto& member = static_cast<PartValue&>(*members[slot]);
+        Int newValue = calcPartValue(part);
+        if (member.value == newValue) {
+            continue;
+        }
+        member.changeValue([&]() {
+            member.value = newValue;
+            return true;
+        });
+        this->template changeSubsequenceAndNotify<IntView>(slot, slot + 1);
+    }
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::reevaluateImpl(
+    PartitionView& operandView) {
+    this->silentClear();
+    memberWeights.clear();
+    lib::visit(
+        [&](auto& operandMembers) {
+            for (auto& member : operandMembers) {
+                memberWeights.emplace_back(weigh(member));
+            }
+        },
+        operandView.members);
+    size_t numberParts = operandView.partInfo.size();
+    if (aggregate == PartitionAggregate::SUM) {
+        partTotals.assign(numberParts, 0);
+    } else {
+        partWeightCounts.assign(numberParts, {});
+    }
+    for (size_t i = 0; i < memberWeights.size(); i++) {
+        addWeight(operandView.memberPartMap[i], memberWeights[i]);
+    }
+    partSlotMap.assign(numberParts, -1);
+    slotPartMap.clear();
+    for (size_t part = 0; part < numberParts; part++) {
+        if (operandView.partInfo[part].partSize == 0) {
+            continue;
+        }
+        partSlotMap[part] = slotPartMap.size();
+        slotPartMap.emplace_back(part);
+        this->addMember(partSlotMap[part], makePartValue(part));
+    }
+}
+
+template <PartitionAggregate aggregate>
+class OperatorTrates<OpPartitionAggregate<aggregate>>::OperandTrigger
+    : public PartitionTrigger {
+   public:
+    OpPartitionAggregate<aggregate>* op;
+    OperandTrigger(OpPartitionAggregate<aggregate>* op) : op(op) {}
+
+    void containingPartsSwapped(UInt member1, UInt member2) final {
+        // each member is now in the part the other was in.
+        auto& memberPartMap = op->operand->view()->memberPartMap;
+        op->membersMoved({member1, member2},
+                         {memberPartMap[member2], memberPartMap[member1]});
+    }
+
+    void membersMovedToPart(const vector<UInt>& memberIndices,
+                            const vector<UInt>& oldParts, UInt) final {
+        op->membersMoved(memberIndices, oldParts);
+    }
+
+    void membersMovedFromPart(UInt part, const vector<UInt>& memberIndices,
+                              const vector<UInt>&) final {
+        op->membersMoved(memberIndices,
+                         vector<UInt>(memberIndices.size(), part));
+    }
+
+    void valueChanged() final {
+        op->reevaluate();
+        op->notifyEntireValueChanged();
+    }
+
+    void reattachTrigger() final {
+        auto trigger = make_shared<OperandTrigger>(op);
+        op->operand->addTrigger(trigger);
+        op->operandTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { todoImpl(); }
+    void hasBecomeDefined() final { todoImpl(); }
+    void memberReplaced(UInt index, const AnyExprRef& oldMember) final {
+        todoImpl(index, oldMember);
+    }
+};
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::updateOwnedValueViolations(
+    UInt part, const ViolationContext& vioContext,
+    ViolationContainer& vioContainer) {
+    auto& operandView = *this->operand->view();
+    lib::visit(
+        [&](auto& operandMembers) {
+            for (size_t i = 0; i < operandMembers.size(); i++) {
+                if (operandView.memberPartMap[i] == part) {
+                    operandMembers[i]->updateVarViolations(vioContext,
+                                                           vioContainer);
+                }
+            }
+        },
+        operandView.members);
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::updateVarViolationsImpl(
+    const ViolationContext& vioContext, ViolationContainer& vioContainer) {
+    this->operand->updateVarViolations(vioContext, vioContainer);
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::copy(
+    OpPartitionAggregate& newOp) const {
+    newOp.term = term;
+    newOp.termIterId = termIterId;
+    newOp.termCache = termCache;
+}
+
+template <PartitionAggregate aggregate>
+std::ostream& OpPartitionAggregate<aggregate>::dumpState(
+    std::ostream& os) const {
+    os << getOpName() << "(value=" << this->getViewIfDefined()
+       << "\nmemberWeights: " << memberWeights
+       << "\npartSlotMap: " << partSlotMap
+       << "\nslotPartMap: " << slotPartMap << ",\noperand=";
+    return this->operand->dumpState(os) << ")";
+}
+
+template <PartitionAggregate aggregate>
+string OpPartitionAggregate<aggregate>::getOpName() const {
+    switch (aggregate) {
+        case PartitionAggregate::SUM:
+            return "OpPartitionSum";
+        case PartitionAggregate::MIN:
+            return "OpPartitionMin";
+        case PartitionAggregate::MAX:
+            return "OpPartitionMax";
+    }
+    shouldNotBeCalledPanic;
+}
+
+template <PartitionAggregate aggregate>
+void OpPartitionAggregate<aggregate>::debugSanityCheckImpl() const {
+    this->operand->debugSanityCheck();
+    auto viewOption = this->operand->getViewIfDefined();
+    sanityCheck(viewOption, "operand should be defined.");
+    auto& view = *viewOption;
+    sanityEqualsCheck(view.numberElements(), memberWeights.size());
+    lib::visit(
+        [&](auto& operandMembers) {
+            for (size_t i = 0; i < operandMembers.size(); i++) {
+                HashType hash = getValueHash(operandMembers[i]);
+                sanityCheck(termCache->count(hash),
+                            toString("weight of member ", i, " not cached."));
+                sanityEqualsCheck(termCache->at(hash), memberWeights[i]);
+            }
+        },
+        view.members);
+    vector<lib::optional<Int>> checkValues(view.partInfo.size());
+    for (size_t i = 0; i < memberWeights.size(); i++) {
+        auto& checkValue = checkValues[view.memberPartMap[i]];
+        Int weight = memberWeights[i];
+        if (!checkValue) {
+            checkValue = weight;
+        } else if (aggregate == PartitionAggregate::SUM) {
+            *checkValue += weight;
+        } else if (aggregate == PartitionAggregate::MIN) {
+            checkValue = min(*checkValue, weight);
+        } else {
+            checkValue = max(*checkValue, weight);
+        }
+    }
+    auto& members = this->template getMembers<IntView>();
+    sanityEqualsCheck(view.numberParts(), members.size());
+    sanityEqualsCheck(members.size(), slotPartMap.size());
+    sanityEqualsCheck(view.partInfo.size(), partSlotMap.size());
+    for (size_t part = 0; part < partSlotMap.size(); part++) {
+        if (view.partInfo[part].partSize == 0) {
+            sanityEqualsCheck(-1, partSlotMap[part]);
+            continue;
+        }
+        Int slot = partSlotMap[part];
+        sanityCheck(slot >= 0 && slot < (Int)members.size(),
+                    toString("slot of part ", part, " out of range."));
+        sanityEqualsCheck(part, slotPartMap[slot]);
+        sanityEqualsCheck(part,
+                          static_cast<const PartValue&>(*members[slot]).index);
+        sanityEqualsCheck(*checkValues[part], calcPartValue(part));
+        sanityEqualsCheck(*checkValues[part], members[slot]->view()->value);
+    }
+    this->standardSanityChecksForThisType();
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <PartitionAggregate aggregate>
+struct OpMaker<OpPartitionAggregate<aggregate>> {
+    static ExprRef<SequenceView> make(ExprRef<PartitionView> partition,
+                                      ExprRef<IntView> term,
+                                      UInt64 termIterId);
+};
+
+template <PartitionAggregate aggregate>
+ExprRef<SequenceView> OpMaker<OpPartitionAggregate<aggregate>>::make(
+    ExprRef<PartitionView> partition, ExprRef<IntView> term,
+    UInt64 termIterId) {
+    auto op = make_shared<OpPartitionAggregate<aggregate>>(move(partition));
+    op->term = move(term);
+    op->termIterId = termIterId;
+    return op;
+}
+
+template struct OpPartitionAggregate<PartitionAggregate::SUM>;
+template struct OpMaker<OpPartitionAggregate<PartitionAggregate::SUM>>;
+template struct OpPartitionAggregate<PartitionAggregate::MIN>;
+template struct OpMaker<OpPartitionAggregate<PartitionAggregate::MIN>>;
+template struct OpPartitionAggregate<PartitionAggregate::MAX>;
+template struct OpMaker<OpPartitionAggregate<PartitionAggregate::MAX>>;
@@ -0,0 +1,89 @@
+#ifndef SRC_OPERATORS_OPPARTITIONAGGREGATE_H_
+#define SRC_OPERATORS_OPPARTITIONAGGREGATE_H_
+#include <map>
+
+#include "operators/ownedIntValue.h"
+#include "operators/simpleOperator.h"
+#include "types/int.h"
+#include "types/partition.h"
+#include "types/sequence.h"
+
+enum class PartitionAggregate { SUM, MIN, MAX };
+
+// a sequence of ints, one for each non empty part of the operand partition,
+// the sum, min or max of the weights of the members in that part.  The
+// weight of a member is term with the iterator termIterId bound to that
+// member.  term may otherwise only refer to constants, so each distinct
+// member is weighed once.  Not parsed directly, the optimiser produces it as
+// the container of quantifiers of the form
+// [f(sum([w(i) | i <- p])) | p <- parts(P)], so that moving members between
+// parts updates the parts involved rather than the sets of parts(P).  Like
+// parts(P), the order of the parts is arbitrary.
+template <PartitionAggregate aggregate>
+struct OpPartitionAggregate;
+template <PartitionAggregate aggregate>
+struct OperatorTrates<OpPartitionAggregate<aggregate>> {
+    class OperandTrigger;
+};
+
+template <PartitionAggregate aggregate>
+struct OpPartitionAggregate
+    : public SimpleUnaryOperator<SequenceView, PartitionView,
+                                 OpPartitionAggregate<aggregate>> {
+    // the members of this op, index is the part.
+    typedef OwnedIntValue<OpPartitionAggregate<aggregate>> PartValue;
+    ExprRef<IntView> term = nullptr;
+    UInt64 termIterId = 0;
+    // weight of each member value by its hash, shared between copies of this
+    // op.
+    std::shared_ptr<HashMap<HashType, Int>> termCache =
+        std::make_shared<HashMap<HashType, Int>>();
+    std::vector<Int> memberWeights;
+    // for sums, the total weight in each part.
+    std::vector<Int> partTotals;
+    // for min and max, the number of members of each weight in each part.
+    std::vector<std::map<Int, UInt>> partWeightCounts;
+    // the member of this op holding each part, -1 for empty parts, and the
+    // part held by each member.
+    std::vector<Int> partSlotMap;
+    std::vector<UInt> slotPartMap;
+
+    OpPartitionAggregate(ExprRef<PartitionView> operand)
+        : SimpleUnaryOperator<SequenceView, PartitionView,
+                              OpPartitionAggregate<aggregate>>(
+              std::move(operand)) {
+        this->members.template emplace<ExprRefVec<IntView>>();
+    }
+    OpPartitionAggregate(OpPartitionAggregate&&) = delete;
+
+    template <typename View>
+    Int weigh(const ExprRef<View>& member);
+    void addWeight(UInt part, Int weight);
+    void removeWeight(UInt part, Int weight);
+    Int calcPartValue(UInt part) const;
+    // the members at memberIndices have moved from oldParts to the parts
+    // given by the operand.  Only the parts involved are updated, in O(1)
+    // for sums and O(log n) for min and max.
+    void membersMoved(const std::vector<UInt>& memberIndices,
+                      const std::vector<UInt>& oldParts);
+    void addSlotAndNotify(UInt part);
+    void removeSlotAndNotify(UInt part);
+    ExprRef<IntView> makePartValue(UInt part);
+    // forwards violations on a part to the operand members in it.
+    void updateOwnedValueViolations(UInt part,
+                                    const ViolationContext& vioContext,
+                                    ViolationContainer& vioContainer);
+
+    void reevaluateImpl(PartitionView& operandView);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpPartitionAggregate& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+
+typedef OpPartitionAggregate<PartitionAggregate::SUM> OpPartitionSum;
+typedef OpPartitionAggregate<PartitionAggregate::MIN> OpPartitionMin;
+typedef OpPartitionAggregate<PartitionAggregate::MAX> OpPartitionMax;
+#endif /* SRC_OPERATORS_OPPARTITIONAGGREGATE_H_ */
@@ -90,7 +90,7 @@ class OperatorTrates<OpProd>::OperandsSequenceTrigger : public SequenceTrigger {
             return;
         }
 
-        swap(op->cachedValues.get(index1), op->cachedValues.get(index2));
+        op->cachedValues.swap(index1, index2);
     }
 
     ExprRef<IntView>& getMember(SequenceView& operandView, UInt index) {
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <memory>
 
+#include "operators/opCount.h"
 #include "operators/simpleOperator.hpp"
 #include "types/sequence.h"
 
@@ -23,6 +24,16 @@ std::ostream& OpSequenceSize::dumpState(std::ostream& os) const {
     operand->dumpState(os);
     return os;
 }
+std::pair<bool, ExprRef<IntView>> OpSequenceSize::optimiseImpl(
+    ExprRef<IntView>& self, PathExtension path) {
+    auto optResult = standardOptimise(self, path);
+    auto countTest = optimiseSequenceSizeToCount(optResult.second->operand);
+    if (countTest) {
+        return make_pair(true, *countTest);
+    }
+    return optResult;
+}
+
 string OpSequenceSize::getOpName() const { return "OpSequenceSize"; }
 void OpSequenceSize::debugSanityCheckImpl() const {
     operand->debugSanityCheck();
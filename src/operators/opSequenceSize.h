@@ -20,6 +20,8 @@ struct OpSequenceSize
                                  ViolationContainer& vioContainer) final;
     void copy(OpSequenceSize& newOp) const;
     std::ostream& dumpState(std::ostream& os) const final;
+    std::pair<bool, ExprRef<IntView>> optimiseImpl(ExprRef<IntView>&,
+                                                   PathExtension path) final;
     std::string getOpName() const final;
     void debugSanityCheckImpl() const final;
 };
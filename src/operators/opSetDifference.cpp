@@ -0,0 +1,219 @@
+#include "operators/opSetDifference.h"
+
+#include <iostream>
+#include <memory>
+
+#include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "types/set.h"
+using namespace std;
+static const char* NO_UNDEFINED_IN_SETDIFFERENCE =
+    "OpSetDifference does not yet handle all the cases where sets become "
+    "undefined.  "
+    "Especially if returned views are undefined\n";
+
+void OpSetDifference::reevaluateImpl(SetView& leftView, SetView& rightView,
+                                     bool, bool) {
+    silentClear();
+    mpark::visit(
+        [&](auto& leftMembers) {
+            this->members.emplace<ExprRefVec<viewType(leftMembers)>>();
+            for (size_t i = 0; i < leftMembers.size(); i++) {
+                if (!rightView.hashIndexMap.count(leftView.indexHashMap[i])) {
+                    this->addMember(leftMembers[i]);
+                }
+            }
+        },
+        leftView.members);
+}
+
+namespace {
+HashType getHashForceDefined(const AnyExprRef& expr) {
+    return lib::visit(
+        [&](auto& expr) {
+            auto view = expr->getViewIfDefined();
+            if (!view) {
+                myCerr << NO_UNDEFINED_IN_SETDIFFERENCE;
+                myAbort();
+            }
+            return getValueHash(*view);
+        },
+        expr);
+}
+}  // namespace
+
+void OpSetDifference::updateMember(HashType hash) {
+    auto& leftView =
+        left->getViewIfDefined().checkedGet(NO_UNDEFINED_IN_SETDIFFERENCE);
+    auto& rightView =
+        right->getViewIfDefined().checkedGet(NO_UNDEFINED_IN_SETDIFFERENCE);
+    mpark::visit(
+        [&](auto& members) {
+            typedef viewType(members) InnerViewType;
+            auto leftIter = leftView.hashIndexMap.find(hash);
+            bool shouldContain = leftIter != leftView.hashIndexMap.end() &&
+                                 !rightView.hashIndexMap.count(hash);
+            auto iter = hashIndexMap.find(hash);
+            if (iter != hashIndexMap.end()) {
+                if (shouldContain &&
+                    &(*members[iter->second]) ==
+                        &(*leftView.getMembers<InnerViewType>()
+                               [leftIter->second])) {
+                    return;
+                }
+                this->removeMemberAndNotify<InnerViewType>(iter->second);
+            }
+            if (shouldContain) {
+                this->addMemberAndNotify(
+                    leftView.getMembers<InnerViewType>()[leftIter->second]);
+            }
+        },
+        this->members);
+}
+
+template <bool isLeft>
+struct OperatorTrates<OpSetDifference>::OperandTrigger : public SetTrigger {
+   public:
+    OpSetDifference* op;
+
+   public:
+    OperandTrigger(OpSetDifference* op) : op(op) {}
+    void valueRemoved(UInt, HashType hash) { op->updateMember(hash); }
+    void valueAdded(const AnyExprRef& member) {
+        op->updateMember(getHashForceDefined(member));
+    }
+    inline void valueChanged() final {
+        op->reevaluate(isLeft, !isLeft);
+        op->notifyEntireValueChanged();
+    }
+    inline SetView& operandView() {
+        auto view = (isLeft) ? op->left->getViewIfDefined()
+                             : op->right->getViewIfDefined();
+        return view.checkedGet(NO_UNDEFINED_IN_SETDIFFERENCE);
+    }
+    void memberReplaced(UInt index, const AnyExprRef& oldMember) {
+        op->updateMember(getHashForceDefined(oldMember));
+        op->updateMember(operandView().indexHashMap[index]);
+    }
+    inline void memberValueChanged(UInt index, HashType oldHash) final {
+        op->updateMember(oldHash);
+        op->updateMember(operandView().indexHashMap[index]);
+    }
+
+    inline void memberValuesChanged(
+        const std::vector<UInt>& indices,
+        const std::vector<HashType>& oldHashes) final {
+        for (HashType hash : oldHashes) {
+            op->updateMember(hash);
+        }
+        auto& view = operandView();
+        for (auto index : indices) {
+            op->updateMember(view.indexHashMap[index]);
+        }
+    }
+
+    void reattachTrigger() final {
+        if (isLeft) {
+            reattachLeftTrigger();
+        } else {
+            reattachRightTrigger();
+        }
+    }
+    void reattachLeftTrigger() {
+        auto trigger = make_shared<
+            OperatorTrates<OpSetDifference>::OperandTrigger<true>>(op);
+        op->left->addTrigger(trigger);
+        op->leftTrigger = trigger;
+    }
+
+    void reattachRightTrigger() {
+        auto trigger = make_shared<
+            OperatorTrates<OpSetDifference>::OperandTrigger<false>>(op);
+        op->right->addTrigger(trigger);
+        op->rightTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { todoImpl(); }
+    void hasBecomeDefined() final { todoImpl(); }
+};
+
+void OpSetDifference::updateVarViolationsImpl(
+    const ViolationContext& vioContext, ViolationContainer& vioContainer) {
+    left->updateVarViolations(vioContext, vioContainer);
+    right->updateVarViolations(vioContext.parentViolation, vioContainer);
+    auto* intVioContextTest =
+        dynamic_cast<const IntViolationContext*>(&vioContext);
+    bool differenceTooLarge =
+        intVioContextTest &&
+        intVioContextTest->reason == IntViolationContext::Reason::TOO_LARGE;
+    if (!differenceTooLarge) {
+        return;
+    }
+    // the members left over are the ones to blame.
+    mpark::visit(
+        [&](auto& members) {
+            for (auto& member : members) {
+                member->updateVarViolations(1, vioContainer);
+            }
+        },
+        this->members);
+}
+
+void OpSetDifference::copy(OpSetDifference&) const {}
+
+std::ostream& OpSetDifference::dumpState(std::ostream& os) const {
+    os << "OpSetDifference: value=" << this->getViewIfDefined() << "\nLeft: ";
+    left->dumpState(os);
+    os << "\nRight: ";
+    right->dumpState(os);
+    return os;
+}
+
+string OpSetDifference::getOpName() const { return "OpSetDifference"; }
+void OpSetDifference::debugSanityCheckImpl() const {
+    left->debugSanityCheck();
+    right->debugSanityCheck();
+    auto leftOption = left->getViewIfDefined();
+    auto rightOption = right->getViewIfDefined();
+    if (!leftOption || !rightOption) {
+        todoImpl();
+        return;
+    }
+    auto& leftView = *leftOption;
+    auto& rightView = *rightOption;
+    standardSanityChecksForThisType();
+    mpark::visit(
+        [&](auto& leftMembers) {
+            auto& opMembers =
+                mpark::get<ExprRefVec<viewType(leftMembers)>>(this->members);
+            size_t numberFound = 0;
+            for (size_t i = 0; i < leftMembers.size(); i++) {
+                HashType hash = leftView.indexHashMap[i];
+                if (!rightView.hashIndexMap.count(hash)) {
+                    sanityCheck(
+                        this->hashIndexMap.count(hash),
+                        toString("left set member index ", i, " hash ", hash,
+                                 " is not in right set but is not in "
+                                 "parent."));
+                    sanityEqualsCheck(&(*leftMembers[i]),
+                                      &(*opMembers[hashIndexMap.at(hash)]));
+                    ++numberFound;
+                }
+            }
+            sanityEqualsCheck(numberFound, numberElements());
+        },
+        leftView.members);
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <>
+struct OpMaker<OpSetDifference> {
+    static ExprRef<SetView> make(ExprRef<SetView> l, ExprRef<SetView> r);
+};
+
+ExprRef<SetView> OpMaker<OpSetDifference>::make(ExprRef<SetView> l,
+                                                ExprRef<SetView> r) {
+    return make_shared<OpSetDifference>(move(l), move(r));
+}
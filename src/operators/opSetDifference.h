@@ -0,0 +1,32 @@
+
+#ifndef SRC_OPERATORS_OPSETDIFFERENCE_H_
+#define SRC_OPERATORS_OPSETDIFFERENCE_H_
+#include "operators/simpleOperator.h"
+#include "types/bool.h"
+#include "types/set.h"
+// the members of left that are not in right.
+struct OpSetDifference;
+template <>
+struct OperatorTrates<OpSetDifference> {
+    template <bool isLeft>
+    struct OperandTrigger;
+    typedef OperandTrigger<true> LeftTrigger;
+    typedef OperandTrigger<false> RightTrigger;
+};
+struct OpSetDifference
+    : public SimpleBinaryOperator<SetView, SetView, SetView, OpSetDifference> {
+    using SimpleBinaryOperator<SetView, SetView, SetView,
+                               OpSetDifference>::SimpleBinaryOperator;
+
+    void reevaluateImpl(SetView& leftView, SetView& rightView, bool, bool);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpSetDifference& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+    // bring the member with the given hash in line with the operands, called
+    // for each hash added to or removed from an operand.
+    void updateMember(HashType hash);
+};
+#endif /* SRC_OPERATORS_OPSETDIFFERENCE_H_ */
@@ -0,0 +1,228 @@
+#include "operators/opSetUnion.h"
+
+#include <iostream>
+#include <memory>
+
+#include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "types/set.h"
+using namespace std;
+static const char* NO_UNDEFINED_IN_SETUNION =
+    "OpSetUnion does not yet handle all the cases where sets become "
+    "undefined.  "
+    "Especially if returned views are undefined\n";
+
+void OpSetUnion::reevaluateImpl(SetView& leftView, SetView& rightView, bool,
+                                bool) {
+    silentClear();
+    mpark::visit(
+        [&](auto& leftMembers) {
+            this->members.emplace<ExprRefVec<viewType(leftMembers)>>();
+            for (auto& member : leftMembers) {
+                this->addMember(member);
+            }
+            if (rightView.numberElements() == 0) {
+                return;
+            }
+            auto& rightMembers =
+                rightView.getMembers<viewType(leftMembers)>();
+            for (size_t i = 0; i < rightMembers.size(); i++) {
+                if (!hashIndexMap.count(rightView.indexHashMap[i])) {
+                    this->addMember(rightMembers[i]);
+                }
+            }
+        },
+        leftView.members);
+}
+
+namespace {
+HashType getHashForceDefined(const AnyExprRef& expr) {
+    return lib::visit(
+        [&](auto& expr) {
+            auto view = expr->getViewIfDefined();
+            if (!view) {
+                myCerr << NO_UNDEFINED_IN_SETUNION;
+                myAbort();
+            }
+            return getValueHash(*view);
+        },
+        expr);
+}
+
+// the member of view with the given hash, nullptr if there is none.
+template <typename InnerViewType>
+const ExprRef<InnerViewType>* memberWithHash(SetView& view, HashType hash) {
+    auto iter = view.hashIndexMap.find(hash);
+    if (iter == view.hashIndexMap.end()) {
+        return nullptr;
+    }
+    return &view.getMembers<InnerViewType>()[iter->second];
+}
+
+template <typename InnerViewType>
+bool isSameMember(const ExprRef<InnerViewType>* expected,
+                  const ExprRef<InnerViewType>& member) {
+    return expected && &(**expected) == &(*member);
+}
+}  // namespace
+
+void OpSetUnion::updateMember(HashType hash) {
+    auto& leftView =
+        left->getViewIfDefined().checkedGet(NO_UNDEFINED_IN_SETUNION);
+    auto& rightView =
+        right->getViewIfDefined().checkedGet(NO_UNDEFINED_IN_SETUNION);
+    mpark::visit(
+        [&](auto& members) {
+            typedef viewType(members) InnerViewType;
+            auto leftMember = memberWithHash<InnerViewType>(leftView, hash);
+            auto rightMember = memberWithHash<InnerViewType>(rightView, hash);
+            auto iter = hashIndexMap.find(hash);
+            if (iter != hashIndexMap.end()) {
+                auto& member = members[iter->second];
+                if (isSameMember(leftMember, member) ||
+                    isSameMember(rightMember, member)) {
+                    return;
+                }
+                // the operand member representing hash has gone, possibly
+                // leaving the same value in the other operand.
+                this->removeMemberAndNotify<InnerViewType>(iter->second);
+            }
+            auto replacement = (leftMember) ? leftMember : rightMember;
+            if (replacement) {
+                this->addMemberAndNotify(*replacement);
+            }
+        },
+        this->members);
+}
+
+template <bool isLeft>
+struct OperatorTrates<OpSetUnion>::OperandTrigger : public SetTrigger {
+   public:
+    OpSetUnion* op;
+
+   public:
+    OperandTrigger(OpSetUnion* op) : op(op) {}
+    void valueRemoved(UInt, HashType hash) { op->updateMember(hash); }
+    void valueAdded(const AnyExprRef& member) {
+        op->updateMember(getHashForceDefined(member));
+    }
+    inline void valueChanged() final {
+        op->reevaluate(isLeft, !isLeft);
+        op->notifyEntireValueChanged();
+    }
+    inline SetView& operandView() {
+        auto view = (isLeft) ? op->left->getViewIfDefined()
+                             : op->right->getViewIfDefined();
+        return view.checkedGet(NO_UNDEFINED_IN_SETUNION);
+    }
+    void memberReplaced(UInt index, const AnyExprRef& oldMember) {
+        op->updateMember(getHashForceDefined(oldMember));
+        op->updateMember(operandView().indexHashMap[index]);
+    }
+    inline void memberValueChanged(UInt index, HashType oldHash) final {
+        op->updateMember(oldHash);
+        op->updateMember(operandView().indexHashMap[index]);
+    }
+
+    inline void memberValuesChanged(
+        const std::vector<UInt>& indices,
+        const std::vector<HashType>& oldHashes) final {
+        for (HashType hash : oldHashes) {
+            op->updateMember(hash);
+        }
+        auto& view = operandView();
+        for (auto index : indices) {
+            op->updateMember(view.indexHashMap[index]);
+        }
+    }
+
+    void reattachTrigger() final {
+        if (isLeft) {
+            reattachLeftTrigger();
+        } else {
+            reattachRightTrigger();
+        }
+    }
+    void reattachLeftTrigger() {
+        auto trigger =
+            make_shared<OperatorTrates<OpSetUnion>::OperandTrigger<true>>(op);
+        op->left->addTrigger(trigger);
+        op->leftTrigger = trigger;
+    }
+
+    void reattachRightTrigger() {
+        auto trigger =
+            make_shared<OperatorTrates<OpSetUnion>::OperandTrigger<false>>(op);
+        op->right->addTrigger(trigger);
+        op->rightTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { todoImpl(); }
+    void hasBecomeDefined() final { todoImpl(); }
+};
+
+void OpSetUnion::updateVarViolationsImpl(const ViolationContext& vioContext,
+                                         ViolationContainer& vioContainer) {
+    left->updateVarViolations(vioContext, vioContainer);
+    right->updateVarViolations(vioContext, vioContainer);
+}
+
+void OpSetUnion::copy(OpSetUnion&) const {}
+
+std::ostream& OpSetUnion::dumpState(std::ostream& os) const {
+    os << "OpSetUnion: value=" << this->getViewIfDefined() << "\nLeft: ";
+    left->dumpState(os);
+    os << "\nRight: ";
+    right->dumpState(os);
+    return os;
+}
+
+string OpSetUnion::getOpName() const { return "OpSetUnion"; }
+void OpSetUnion::debugSanityCheckImpl() const {
+    left->debugSanityCheck();
+    right->debugSanityCheck();
+    auto leftOption = left->getViewIfDefined();
+    auto rightOption = right->getViewIfDefined();
+    if (!leftOption || !rightOption) {
+        todoImpl();
+        return;
+    }
+    auto& leftView = *leftOption;
+    auto& rightView = *rightOption;
+    standardSanityChecksForThisType();
+    mpark::visit(
+        [&](auto& opMembers) {
+            typedef viewType(opMembers) InnerViewType;
+            size_t numberFound = leftView.numberElements();
+            for (auto& hashIndexPair : rightView.hashIndexMap) {
+                if (!leftView.hashIndexMap.count(hashIndexPair.first)) {
+                    ++numberFound;
+                }
+            }
+            sanityEqualsCheck(numberFound, numberElements());
+            for (size_t i = 0; i < opMembers.size(); i++) {
+                HashType hash = indexHashMap[i];
+                auto leftMember = memberWithHash<InnerViewType>(leftView, hash);
+                auto rightMember =
+                    memberWithHash<InnerViewType>(rightView, hash);
+                sanityCheck(isSameMember(leftMember, opMembers[i]) ||
+                                isSameMember(rightMember, opMembers[i]),
+                            toString("member index ", i, " hash ", hash,
+                                     " is not a member of either operand."));
+            }
+        },
+        this->members);
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <>
+struct OpMaker<OpSetUnion> {
+    static ExprRef<SetView> make(ExprRef<SetView> l, ExprRef<SetView> r);
+};
+
+ExprRef<SetView> OpMaker<OpSetUnion>::make(ExprRef<SetView> l,
+                                           ExprRef<SetView> r) {
+    return make_shared<OpSetUnion>(move(l), move(r));
+}
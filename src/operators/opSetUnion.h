@@ -0,0 +1,34 @@
+
+#ifndef SRC_OPERATORS_OPSETUNION_H_
+#define SRC_OPERATORS_OPSETUNION_H_
+#include "operators/simpleOperator.h"
+#include "types/bool.h"
+#include "types/set.h"
+// the members of left together with the members of right.  A value held by
+// both operands is represented by the member of just one of them, the
+// operands' own hash maps count which operands hold each value.
+struct OpSetUnion;
+template <>
+struct OperatorTrates<OpSetUnion> {
+    template <bool isLeft>
+    struct OperandTrigger;
+    typedef OperandTrigger<true> LeftTrigger;
+    typedef OperandTrigger<false> RightTrigger;
+};
+struct OpSetUnion
+    : public SimpleBinaryOperator<SetView, SetView, SetView, OpSetUnion> {
+    using SimpleBinaryOperator<SetView, SetView, SetView,
+                               OpSetUnion>::SimpleBinaryOperator;
+
+    void reevaluateImpl(SetView& leftView, SetView& rightView, bool, bool);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpSetUnion& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+    // bring the member with the given hash in line with the operands, called
+    // for each hash added to or removed from an operand.
+    void updateMember(HashType hash);
+};
+#endif /* SRC_OPERATORS_OPSETUNION_H_ */
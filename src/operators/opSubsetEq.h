@@ -1,6 +1,6 @@
 
-#ifndef SRC_OPERATORS_OPSETINTERSECT_H_
-#define SRC_OPERATORS_OPSETINTERSECT_H_
+#ifndef SRC_OPERATORS_OPSUBSETEQ_H_
+#define SRC_OPERATORS_OPSUBSETEQ_H_
 #include "operators/simpleOperator.h"
 #include "types/bool.h"
 #include "types/set.h"
@@ -27,4 +27,4 @@ struct OpSubsetEq
     void debugSanityCheckImpl() const final;
     void hashChecksImpl() const final;
 };
-#endif /* SRC_OPERATORS_OPSETINTERSECT_H_ */
+#endif /* SRC_OPERATORS_OPSUBSETEQ_H_ */
@@ -5,9 +5,11 @@
 #include <unordered_map>
 
 #include "operators/flatten.h"
+#include "operators/foldingOperator.hpp"
+#include "operators/opCount.h"
+#include "operators/opLinear.h"
 #include "operators/previousValueCache.h"
 #include "operators/shiftViolatingIndices.h"
-#include "operators/simpleOperator.hpp"
 #include "types/intVal.h"
 #include "types/sequenceVal.h"
 #include "utils/ignoreUnused.h"
@@ -29,15 +31,15 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
         auto& expr = lib::get<ExprRef<IntView>>(exprIn);
         auto view = expr->getViewIfDefined();
         if (!view) {
-            op->cachedValues.insert(index, 0);
+            op->insertCachedValue(index, 0);
             if (op->operand->view()->numberUndefined == 1) {
                 op->setUndefinedAndTrigger();
             }
             return;
         }
         Int operandValue = (*view).value;
-        op->cachedValues.insert(index, operandValue);
-        op->changeValue([&]() {
+        op->insertCachedValue(index, operandValue);
+        op->changeValueDeferred([&]() {
             op->addSingleValue(operandValue);
             return true;
         });
@@ -52,7 +54,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
         }
         const auto& expr = lib::get<ExprRef<IntView>>(exprIn);
 
-        Int operandValue = op->cachedValues.erase(index);
+        Int operandValue = op->eraseCachedValue(index);
 
         if (!expr->appearsDefined()) {
             if (op->operand->view()->numberUndefined == 0) {
@@ -60,7 +62,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
             }
             return;
         }
-        op->changeValue([&]() {
+        op->changeValueDeferred([&]() {
             op->removeSingleValue(operandValue);
             return true;
         });
@@ -70,8 +72,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
         if (!op->evaluationComplete) {
             return;
         }
-
-        swap(op->cachedValues.get(index1), op->cachedValues.get(index2));
+        op->swapCachedValues(index1, index2);
     }
 
     ExprRef<IntView>& getMember(SequenceView& operandView, UInt index) {
@@ -86,7 +87,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
     inline void handleSingleOperandChange(SequenceView& operandView,
                                           UInt index) {
         Int newValue = getValueCatchUndef(operandView, index);
-        Int oldValue = op->cachedValues.getAndSet(index, newValue);
+        Int oldValue = op->exchangeCachedValue(index, newValue);
         op->removeSingleValue(oldValue);
         op->addSingleValue(newValue);
     }
@@ -103,7 +104,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
             return;
         }
         auto& operandView = *view;
-        op->changeValue([&]() {
+        op->changeValueDeferred([&]() {
             for (size_t i = startIndex; i < endIndex; i++) {
                 handleSingleOperandChange(operandView, i);
             }
@@ -113,7 +114,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
 
     void valueChanged() final {
         bool wasDefined = op->isDefined();
-        op->changeValue([&]() {
+        op->changeValueDeferred([&]() {
             op->reevaluate();
             return op->isDefined();
         });
@@ -138,10 +139,12 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
 
     void memberHasBecomeUndefined(UInt index) {
         if (!op->evaluationComplete) {
+            if (op->fusedOperand) {
+                op->fusedOperand->foldedValue(index) = 0;
+            }
             return;
         }
-        op->removeSingleValue(op->cachedValues.get(index));
-        op->cachedValues.set(index, 0);
+        op->removeSingleValue(op->exchangeCachedValue(index, 0));
         auto view = op->operand->view();
         if (!view) {
             hasBecomeUndefined();
@@ -159,6 +162,10 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
             return;
         }
         if (!op->evaluationComplete) {
+            if (op->fusedOperand) {
+                op->fusedOperand->foldedValue(index) =
+                    getValueCatchUndef(*operandView, index);
+            }
             if ((*operandView).numberUndefined == 0) {
                 op->reevaluateDefinedAndTrigger();
             }
@@ -167,7 +174,7 @@ class OperatorTrates<OpSum>::OperandsSequenceTrigger : public SequenceTrigger {
 
         Int operandValue = getValueCatchUndef(*operandView, index);
         op->addSingleValue(operandValue);
-        op->cachedValues.set(index, operandValue);
+        op->cachedValue(index) = operandValue;
         if ((*operandView).numberUndefined == 0) {
             op->setDefinedAndTrigger();
         }
@@ -182,18 +189,37 @@ void OpSum::reevaluateImpl(SequenceView& operandView) {
     for (size_t index = 0; index < members.size(); index++) {
         auto& operandChild = members[index];
         auto operandChildView = operandChild->getViewIfDefined();
+        Int operandValue = 0;
         if (!operandChildView) {
             setDefined(false);
-            cachedValues.insert(index, 0);
         } else {
-            Int operandValue = (*operandChildView).value;
+            operandValue = (*operandChildView).value;
             addSingleValue(operandValue);
-            cachedValues.insert(index, operandValue);
         }
+        recacheValue(index, operandValue);
     }
     evaluationComplete = true;
 }
 
+Int OpSum::foldValueOf(UInt index) {
+    auto& member = operand->view()->getMembers<IntView>()[index];
+    auto view = member->getViewIfDefined();
+    return (view) ? (*view).value : 0;
+}
+
+void OpSum::unrolledExprChanged(UInt index, Int& foldedValue) {
+    Int newValue = foldValueOf(index);
+    Int oldValue = exchange(foldedValue, newValue);
+    if (!evaluationComplete) {
+        return;
+    }
+    changeValueDeferred([&]() {
+        removeSingleValue(oldValue);
+        addSingleValue(newValue);
+        return isDefined();
+    });
+}
+
 void OpSum::updateVarViolationsImpl(const ViolationContext& vioContext,
                                     ViolationContainer& vioContainer) {
     auto operandView = operand->view();
@@ -206,12 +232,15 @@ void OpSum::updateVarViolationsImpl(const ViolationContext& vioContext,
     }
 }
 
-void OpSum::copy(OpSum&) const {}
+void OpSum::copy(OpSum& newOp) const {
+    newOp.fuseWithOperand = fuseWithOperand;
+}
 
 std::ostream& OpSum::dumpState(std::ostream& os) const {
     os << "OpSum: defined=" << this->appearsDefined()
        << ", operandDefined=" << operand->appearsDefined()
-       << ", evaluationComplete=" << evaluationComplete << ", value=" << value
+       << ", evaluationComplete=" << evaluationComplete
+       << ", fused=" << (fusedOperand != nullptr) << ", value=" << value
        << endl;
     return operand->dumpState(os);
 }
@@ -220,6 +249,16 @@ std::pair<bool, ExprRef<IntView>> OpSum::optimiseImpl(ExprRef<IntView>& self,
                                                       PathExtension path) {
     auto boolOpPair = standardOptimise(self, path);
     boolOpPair.first |= flatten<IntView>(*(boolOpPair.second));
+    auto& newOp = *boolOpPair.second;
+    auto countTest = optimiseSumToCount(newOp.operand);
+    if (countTest) {
+        return make_pair(true, *countTest);
+    }
+    auto linearTest = optimiseSumToLinear(newOp.operand);
+    if (linearTest) {
+        return make_pair(true, *linearTest);
+    }
+    markFusion(newOp);
     return boolOpPair;
 }
 string OpSum::getOpName() const { return "OpSum"; }
@@ -235,16 +274,17 @@ void OpSum::debugSanityCheckImpl() const {
     Int checkValue = 0;
     auto& members = operandView.getMembers<IntView>();
     if (evaluationComplete) {
+        sanityCheckCachedValues(members.size());
         for (size_t index = 0; index < members.size(); index++) {
             auto& operandChild = members[index];
             auto operandChildView = operandChild->getViewIfDefined();
-            sanityCheck(index < cachedValues.size(), "cachedValues too small");
+            Int cached = cachedValue(index);
             if (!operandChildView) {
-                sanityEqualsCheck(0, cachedValues.get(index));
+                sanityEqualsCheck(0, cached);
             } else {
                 Int operandValue = operandChildView->value;
                 checkValue += operandValue;
-                sanityEqualsCheck(operandValue, cachedValues.get(index));
+                sanityEqualsCheck(operandValue, cached);
             }
         }
         sanityEqualsCheck(checkValue, value);
@@ -1,8 +1,7 @@
 
 #ifndef SRC_OPERATORS_OPSUM_H_
 #define SRC_OPERATORS_OPSUM_H_
-#include "operators/previousValueCache.h"
-#include "operators/simpleOperator.h"
+#include "operators/foldingOperator.h"
 #include "types/int.h"
 #include "types/sequence.h"
 #include "utils/fastIterableIntSet.h"
@@ -14,13 +13,13 @@ struct OperatorTrates<OpSum> {
     typedef OperandsSequenceTrigger OperandTrigger;
 };
 
-struct OpSum : public SimpleUnaryOperator<IntView, SequenceView, OpSum> {
-    using SimpleUnaryOperator<IntView, SequenceView,
-                              OpSum>::SimpleUnaryOperator;
+struct OpSum : public FoldingOperator<IntView, OpSum> {
+    using FoldingOperator<IntView, OpSum>::FoldingOperator;
     bool evaluationComplete = false;
-    PreviousValueCache<Int> cachedValues;
     OpSum(OpSum&&) = delete;
     void reevaluateImpl(SequenceView& operandView);
+    Int foldValueOf(UInt index) final;
+    void unrolledExprChanged(UInt index, Int& foldedValue) final;
     void updateVarViolationsImpl(const ViolationContext& vioContext,
                                  ViolationContainer& vioContainer) final;
     void copy(OpSum& newOp) const;
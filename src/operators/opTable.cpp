@@ -0,0 +1,273 @@
+#include "operators/opTable.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "operators/opSequenceLit.h"
+#include "operators/opTupleLit.h"
+#include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "types/setVal.h"
+#include "types/tupleVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+using OperandsSequenceTrigger =
+    OperatorTrates<OpTable>::OperandsSequenceTrigger;
+
+TableIndex::TableIndex(size_t arity, vector<vector<Int>> rowsIn)
+    : arity(arity), rows(move(rowsIn)), columnIndices(arity) {
+    for (size_t row = 0; row < rows.size(); row++) {
+        for (size_t column = 0; column < arity; column++) {
+            columnIndices[column][rows[row][column]].emplace_back(row);
+        }
+    }
+}
+
+void OpTable::setColumnValue(size_t column, Int newValue) {
+    Int oldValue = exchange(columnValues[column], newValue);
+    if (oldValue == newValue) {
+        return;
+    }
+    changeRowMatches(table->rowsWith(column, oldValue), -1);
+    changeRowMatches(table->rowsWith(column, newValue), 1);
+}
+
+UInt OpTable::calcViolation() const {
+    if (table->rows.empty()) {
+        return max<UInt>(table->arity, 1);
+    }
+    UInt maxMatches = table->arity;
+    while (matchFrequencies[maxMatches] == 0) {
+        --maxMatches;
+    }
+    return table->arity - maxMatches;
+}
+
+class OperatorTrates<OpTable>::OperandsSequenceTrigger
+    : public SequenceTrigger {
+   public:
+    OpTable* op;
+    OperandsSequenceTrigger(OpTable* op) : op(op) {}
+    // the operand is a sequence literal, its members are fixed.
+    void valueAdded(UInt, const AnyExprRef&) final { shouldNotBeCalledPanic; }
+    void valueRemoved(UInt, const AnyExprRef&) final {
+        shouldNotBeCalledPanic;
+    }
+    void positionsSwapped(UInt, UInt) final { shouldNotBeCalledPanic; }
+
+    void memberReplaced(UInt index, const AnyExprRef&) final {
+        subsequenceChanged(index, index + 1);
+    }
+
+    void subsequenceChanged(UInt startIndex, UInt endIndex) final {
+        if (!op->allOperandsAreDefined()) {
+            return;
+        }
+        auto& members = op->operand->view()->getMembers<IntView>();
+        for (size_t i = startIndex; i < endIndex; i++) {
+            if (!members[i]->appearsDefined()) {
+                // that trigger will reach this op and the matches will be
+                // recounted once it is defined again.
+                return;
+            }
+        }
+        op->changeValue([&]() {
+            for (size_t i = startIndex; i < endIndex; i++) {
+                op->setColumnValue(i, members[i]->view()->value);
+            }
+            op->violation = op->calcViolation();
+            return true;
+        });
+    }
+
+    void valueChanged() final {
+        op->changeValue([&]() {
+            op->reevaluate();
+            return true;
+        });
+    }
+
+    void reattachTrigger() final {
+        auto trigger = make_shared<OperandsSequenceTrigger>(op);
+        op->operand->addTrigger(trigger);
+        op->operandTrigger = trigger;
+    }
+
+    void hasBecomeUndefined() final { op->setUndefinedAndTrigger(); }
+    void hasBecomeDefined() final { op->reevaluateDefinedAndTrigger(); }
+    void memberHasBecomeUndefined(UInt) final {
+        if (op->operand->view()->numberUndefined == 1) {
+            op->setUndefinedAndTrigger();
+        }
+    }
+    void memberHasBecomeDefined(UInt) final {
+        if (op->operand->view()->numberUndefined == 0) {
+            op->reevaluateDefinedAndTrigger();
+        }
+    }
+};
+
+void OpTable::reevaluateImpl(SequenceView& operandView) {
+    if (operandView.numberUndefined > 0) {
+        setDefined(false);
+        return;
+    }
+    auto& members = operandView.getMembers<IntView>();
+    rowMatches.assign(table->rows.size(), 0);
+    matchFrequencies.assign(table->arity + 1, 0);
+    matchFrequencies[0] = table->rows.size();
+    columnValues.resize(members.size());
+    for (size_t column = 0; column < members.size(); column++) {
+        columnValues[column] = members[column]->view()->value;
+        changeRowMatches(table->rowsWith(column, columnValues[column]), 1);
+    }
+    violation = calcViolation();
+}
+
+void OpTable::updateVarViolationsImpl(const ViolationContext& vioContext,
+                                      ViolationContainer& vioContainer) {
+    if (!allOperandsAreDefined()) {
+        operand->updateVarViolations(vioContext, vioContainer);
+        return;
+    }
+    auto& members = operand->view()->getMembers<IntView>();
+    auto* boolVioContextTest =
+        dynamic_cast<const BoolViolationContext*>(&vioContext);
+    if (boolVioContextTest && boolVioContextTest->negated) {
+        if (violation == 0) {
+            for (auto& member : members) {
+                member->updateVarViolations(1, vioContainer);
+            }
+        }
+        return;
+    }
+    if (violation == 0) {
+        return;
+    }
+    if (table->rows.empty()) {
+        operand->updateVarViolations(vioContext, vioContainer);
+        return;
+    }
+    // blame the operands that differ from the first of the nearest rows.
+    UInt maxMatches = table->arity - violation;
+    for (size_t row = 0; row < table->rows.size(); row++) {
+        if (rowMatches[row] != maxMatches) {
+            continue;
+        }
+        for (size_t column = 0; column < members.size(); column++) {
+            if (table->rows[row][column] != columnValues[column]) {
+                members[column]->updateVarViolations(violation, vioContainer);
+            }
+        }
+        return;
+    }
+}
+
+void OpTable::copy(OpTable& newOp) const { newOp.table = table; }
+
+std::ostream& OpTable::dumpState(std::ostream& os) const {
+    os << "OpTable: violation=" << violation
+       << ", numberRows=" << table->rows.size()
+       << "\ncolumnValues: " << columnValues
+       << "\nmatchFrequencies: " << matchFrequencies << endl;
+    return operand->dumpState(os) << ")";
+}
+
+string OpTable::getOpName() const { return "OpTable"; }
+
+void OpTable::debugSanityCheckImpl() const {
+    operand->debugSanityCheck();
+    auto operandView = operand->getViewIfDefined();
+    if (!operandView) {
+        sanityLargeViolationCheck(violation);
+        return;
+    }
+    auto& members = operandView->getMembers<IntView>();
+    sanityEqualsCheck(table->arity, members.size());
+    sanityEqualsCheck(members.size(), columnValues.size());
+    vector<UInt> checkFrequencies(table->arity + 1, 0);
+    for (size_t row = 0; row < table->rows.size(); row++) {
+        UInt checkMatches = 0;
+        for (size_t column = 0; column < members.size(); column++) {
+            Int value = members[column]->view()->value;
+            sanityEqualsCheck(value, columnValues[column]);
+            checkMatches += table->rows[row][column] == value;
+        }
+        sanityEqualsCheck(checkMatches, rowMatches[row]);
+        ++checkFrequencies[checkMatches];
+    }
+    sanityEqualsCheck(checkFrequencies, matchFrequencies);
+    sanityEqualsCheck(calcViolation(), violation);
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <>
+struct OpMaker<OpTable> {
+    static ExprRef<BoolView> make(ExprRefVec<IntView> operands,
+                                  std::vector<std::vector<Int>> rows);
+};
+
+ExprRef<BoolView> OpMaker<OpTable>::make(ExprRefVec<IntView> operands,
+                                         vector<vector<Int>> rows) {
+    size_t arity = operands.size();
+    auto op =
+        make_shared<OpTable>(make_shared<OpSequenceLit>(move(operands)));
+    op->table = make_shared<TableIndex>(arity, move(rows));
+    return op;
+}
+
+// the int members of a tuple view, nullopt if any are not ints.
+static lib::optional<ExprRefVec<IntView>> getIntMembers(
+    const vector<AnyExprRef>& members) {
+    ExprRefVec<IntView> intMembers;
+    for (auto& member : members) {
+        auto intMemberTest = lib::get_if<ExprRef<IntView>>(&member);
+        if (!intMemberTest) {
+            return lib::nullopt;
+        }
+        intMembers.emplace_back(*intMemberTest);
+    }
+    return intMembers;
+}
+
+lib::optional<ExprRef<BoolView>> optimiseTupleInConstantSet(
+    const AnyExprRef& expr, const ExprRef<SetView>& set) {
+    auto tupleTest = lib::get_if<ExprRef<TupleView>>(&expr);
+    if (!tupleTest || !set->isConstant()) {
+        return lib::nullopt;
+    }
+    auto tupleLitTest = getAs<OpTupleLit>(*tupleTest);
+    if (!tupleLitTest) {
+        return lib::nullopt;
+    }
+    auto operands = getIntMembers(tupleLitTest->members);
+    if (!operands) {
+        return lib::nullopt;
+    }
+    set->evaluate();
+    auto setView = set->getViewIfDefined();
+    if (!setView) {
+        return lib::nullopt;
+    }
+    vector<vector<Int>> rows;
+    for (auto& member : setView->getMembers<TupleView>()) {
+        auto rowTest = getIntMembers(member->view()->members);
+        if (!rowTest || rowTest->size() != operands->size()) {
+            return lib::nullopt;
+        }
+        rows.emplace_back();
+        for (auto& value : *rowTest) {
+            auto valueView = value->getViewIfDefined();
+            if (!valueView) {
+                return lib::nullopt;
+            }
+            rows.back().emplace_back((*valueView).value);
+        }
+    }
+    debug_log("Optimise: tuple literal in constant set to OpTable");
+    return OpMaker<OpTable>::make(move(*operands), move(rows));
+}
+
+template struct SimpleUnaryOperator<BoolView, SequenceView, OpTable>;
@@ -0,0 +1,75 @@
+
+#ifndef SRC_OPERATORS_OPTABLE_H_
+#define SRC_OPERATORS_OPTABLE_H_
+#include <memory>
+#include <vector>
+
+#include "operators/simpleOperator.h"
+#include "types/bool.h"
+#include "types/int.h"
+#include "types/sequence.h"
+#include "types/set.h"
+
+// a constant relation, indexed by the values in each column.
+struct TableIndex {
+    size_t arity;
+    std::vector<std::vector<Int>> rows;
+    // for each column, the rows holding each value in that column.
+    std::vector<HashMap<Int, std::vector<UInt>>> columnIndices;
+    TableIndex(size_t arity, std::vector<std::vector<Int>> rows);
+    inline const std::vector<UInt>& rowsWith(size_t column, Int value) const {
+        static const std::vector<UInt> noRows;
+        auto iter = columnIndices[column].find(value);
+        return (iter != columnIndices[column].end()) ? iter->second : noRows;
+    }
+};
+
+// the int operands, taken as a row, are one of the rows of table.  The
+// violation is the number of operands that must change to reach the nearest
+// row.  Not parsed directly, the optimiser produces it from a tuple literal
+// in a constant set of tuples.  The operand is a sequence literal.
+struct OpTable;
+template <>
+struct OperatorTrates<OpTable> {
+    class OperandsSequenceTrigger;
+    typedef OperandsSequenceTrigger OperandTrigger;
+};
+
+struct OpTable : public SimpleUnaryOperator<BoolView, SequenceView, OpTable> {
+    using SimpleUnaryOperator<BoolView, SequenceView,
+                              OpTable>::SimpleUnaryOperator;
+    // shared between copies of this op
+    std::shared_ptr<const TableIndex> table;
+    // the value of each operand as last counted.
+    std::vector<Int> columnValues;
+    // the number of operands each row agrees with.
+    std::vector<UInt> rowMatches;
+    // matchFrequencies[k] is the number of rows agreeing with k operands.
+    std::vector<UInt> matchFrequencies;
+    OpTable(OpTable&&) = delete;
+    // move the operand at column from its cached value to newValue.
+    void setColumnValue(size_t column, Int newValue);
+    inline void changeRowMatches(const std::vector<UInt>& rowIndices,
+                                 int delta) {
+        for (UInt row : rowIndices) {
+            --matchFrequencies[rowMatches[row]];
+            rowMatches[row] += delta;
+            ++matchFrequencies[rowMatches[row]];
+        }
+    }
+    UInt calcViolation() const;
+    void reevaluateImpl(SequenceView& operandView);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpTable& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+
+// if expr is a tuple literal of ints and set is a constant set of tuples,
+// returns an OpTable to replace expr in set.
+lib::optional<ExprRef<BoolView>> optimiseTupleInConstantSet(
+    const AnyExprRef& expr, const ExprRef<SetView>& set);
+
+#endif /* SRC_OPERATORS_OPTABLE_H_ */
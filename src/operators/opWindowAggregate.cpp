@@ -0,0 +1,344 @@
+#include "operators/opWindowAggregate.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+#include "operators/simpleOperator.hpp"
+#include "types/intVal.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+
+namespace {
+// true if a window holding value a need not consider value b, with b later
+// in the window than a.
+template <WindowAggregate aggregate>
+inline bool dominates(Int a, Int b) {
+    return (aggregate == WindowAggregate::MIN) ? a < b : a > b;
+}
+}  // namespace
+
+template <WindowAggregate aggregate>
+Int OpWindowAggregate<aggregate>::calcWindow(UInt window) const {
+    auto& operandMembers =
+        this->operand->view()->template getMembers<IntView>();
+    UInt start = firstStart + window;
+    Int result = operandMembers[start]->view()->value;
+    for (UInt i = start + 1; i < start + windowSize; i++) {
+        Int value = operandMembers[i]->view()->value;
+        if (aggregate == WindowAggregate::SUM) {
+            result += value;
+        } else if (dominates<aggregate>(value, result)) {
+            result = value;
+        }
+    }
+    return result;
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::setWindowValues(UInt first, UInt last,
+                                                   bool trigger) {
+    if (first >= last) {
+        return;
+    }
+    auto& operandMembers =
+        this->operand->view()->template getMembers<IntView>();
+    auto& members = this->template getMembers<IntView>();
+    auto valueAt = [&](UInt index) {
+        return operandMembers[index]->view()->value;
+    };
+    Int total = 0;
+    deque<UInt> candidates;
+    UInt begin = firstStart + first;
+    UInt end = firstStart + last - 1 + windowSize;
+    for (UInt i = begin; i < end; i++) {
+        Int value = valueAt(i);
+        if (aggregate == WindowAggregate::SUM) {
+            total += value;
+            if (i >= begin + windowSize) {
+                total -= valueAt(i - windowSize);
+            }
+        } else {
+            while (!candidates.empty() &&
+                   !dominates<aggregate>(valueAt(candidates.back()), value)) {
+                candidates.pop_back();
+            }
+            candidates.push_back(i);
+            if (candidates.front() + windowSize <= i) {
+                candidates.pop_front();
+            }
+        }
+        if (i + 1 < begin + windowSize) {
+            continue;
+        }
+        Int windowValue = (aggregate == WindowAggregate::SUM)
+                              ? total
+                              : valueAt(candidates.front());
+        auto& member = static_cast<WindowValue&>(
+            *members[i + 1 - windowSize - firstStart]);
+        if (trigger && member.appearsDefined()) {
+            member.changeValue([&]() {
+                member.value = windowValue;
+                return true;
+            });
+        } else {
+            member.value = windowValue;
+        }
+    }
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::updateWindows(UInt first, UInt last) {
+    auto& members = this->template getMembers<IntView>();
+    UInt fitting = numberFitting(*this->operand->view());
+    // defined windows are a prefix, both before and after this change.
+    UInt definedEnd = first;
+    while (definedEnd < last && members[definedEnd]->appearsDefined()) {
+        ++definedEnd;
+    }
+    setWindowValues(first, min(last, fitting), true);
+    if (first < min(definedEnd, fitting)) {
+        this->template changeSubsequenceAndNotify<IntView>(
+            first, min(definedEnd, fitting));
+    }
+    for (UInt window = first; window < last; window++) {
+        auto& member = static_cast<WindowValue&>(*members[window]);
+        bool fits = window < fitting;
+        if (member.appearsDefined() == fits) {
+            continue;
+        }
+        member.setAppearsDefined(fits);
+        if (fits) {
+            member.notifyValueDefined();
+            this->template defineMemberAndNotify<IntView>(window);
+        } else {
+            member.notifyValueUndefined();
+            this->template undefineMemberAndNotify<IntView>(window);
+        }
+    }
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::operandMembersChanged(UInt start,
+                                                         UInt end) {
+    Int first = max<Int>(
+        (Int)start - (Int)windowSize + 1 - (Int)firstStart, 0);
+    Int last = min<Int>((Int)end - (Int)firstStart, numberWindows);
+    if (first < last) {
+        updateWindows(first, last);
+    }
+}
+
+template <WindowAggregate aggregate>
+ExprRef<IntView> OpWindowAggregate<aggregate>::makeWindowValue(UInt window) {
+    auto member = make_shared<WindowValue>(this, window);
+    bool fits = window < numberFitting(*this->operand->view());
+    member->value = (fits) ? calcWindow(window) : 0;
+    member->setEvaluated(true);
+    member->setAppearsDefined(fits);
+    return ExprRef<IntView>(member);
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::renumberWindows(UInt from) {
+    auto& members = this->template getMembers<IntView>();
+    for (UInt i = from; i < members.size(); i++) {
+        static_cast<WindowValue&>(*members[i]).index = i;
+    }
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::operandMemberAdded(UInt index) {
+    Int offset = (Int)index - (Int)firstStart;
+    if (offset >= (Int)numberWindows) {
+        // no window starts after index, only the windows reaching it change.
+        operandMembersChanged(index, index + 1);
+        return;
+    }
+    // windows starting after index hold what the window before them held.
+    UInt position = max<Int>(offset, 0);
+    this->template removeMemberAndNotify<IntView>(numberWindows - 1);
+    this->addMemberAndNotify(position, makeWindowValue(position));
+    renumberWindows(position);
+    Int first = max<Int>(offset - (Int)windowSize + 1, 0);
+    if (first < (Int)position) {
+        updateWindows(first, position);
+    }
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::operandMemberRemoved(UInt index) {
+    Int offset = (Int)index - (Int)firstStart;
+    if (offset >= (Int)numberWindows) {
+        operandMembersChanged(index, index + 1);
+        return;
+    }
+    // windows starting from index hold what the window after them held.
+    UInt position = max<Int>(offset, 0);
+    this->template removeMemberAndNotify<IntView>(position);
+    renumberWindows(position);
+    this->addMemberAndNotify(numberWindows - 1,
+                             makeWindowValue(numberWindows - 1));
+    Int first = max<Int>(offset - (Int)windowSize + 1, 0);
+    if (first < (Int)position) {
+        updateWindows(first, position);
+    }
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::reevaluateImpl(SequenceView& operandView) {
+    this->silentClear();
+    UInt fitting = numberFitting(operandView);
+    for (UInt window = 0; window < numberWindows; window++) {
+        auto member = make_shared<WindowValue>(this, window);
+        member->setEvaluated(true);
+        member->setAppearsDefined(window < fitting);
+        this->addMember(window, ExprRef<IntView>(member));
+    }
+    setWindowValues(0, fitting, false);
+}
+
+template <WindowAggregate aggregate>
+class OperatorTrates<OpWindowAggregate<aggregate>>::OperandTrigger
+    : public SequenceTrigger {
+   public:
+    OpWindowAggregate<aggregate>* op;
+    OperandTrigger(OpWindowAggregate<aggregate>* op) : op(op) {}
+
+    void valueAdded(UInt index, const AnyExprRef&) final {
+        op->operandMemberAdded(index);
+    }
+
+    void valueRemoved(UInt index, const AnyExprRef&) final {
+        op->operandMemberRemoved(index);
+    }
+
+    void positionsSwapped(UInt index1, UInt index2) final {
+        op->operandMembersChanged(index1, index1 + 1);
+        op->operandMembersChanged(index2, index2 + 1);
+    }
+
+    void memberReplaced(UInt index, const AnyExprRef&) final {
+        subsequenceChanged(index, index + 1);
+    }
+
+    void subsequenceChanged(UInt startIndex, UInt endIndex) final {
+        op->operandMembersChanged(startIndex, endIndex);
+    }
+
+    void valueChanged() final {
+        op->reevaluate();
+        op->notifyEntireValueChanged();
+    }
+
+    void reattachTrigger() final {
+        auto trigger = make_shared<OperandTrigger>(op);
+        op->operand->addTrigger(trigger);
+        op->operandTrigger = trigger;
+    }
+
+    // the operand is a sequence value, it and its members are always
+    // defined.
+    void hasBecomeUndefined() final { shouldNotBeCalledPanic; }
+    void hasBecomeDefined() final { shouldNotBeCalledPanic; }
+    void memberHasBecomeUndefined(UInt) final { shouldNotBeCalledPanic; }
+    void memberHasBecomeDefined(UInt) final { shouldNotBeCalledPanic; }
+};
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::updateOwnedValueViolations(
+    UInt window, const ViolationContext& vioContext,
+    ViolationContainer& vioContainer) {
+    if (window >= numberWindows ||
+        !this->template getMembers<IntView>()[window]->appearsDefined()) {
+        // the operand is too short for this window.
+        this->operand->updateVarViolations(vioContext, vioContainer);
+        return;
+    }
+    auto& operandMembers =
+        this->operand->view()->template getMembers<IntView>();
+    UInt start = firstStart + window;
+    for (UInt i = start; i < start + windowSize; i++) {
+        operandMembers[i]->updateVarViolations(vioContext, vioContainer);
+    }
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::updateVarViolationsImpl(
+    const ViolationContext& vioContext, ViolationContainer& vioContainer) {
+    this->operand->updateVarViolations(vioContext, vioContainer);
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::copy(OpWindowAggregate& newOp) const {
+    newOp.firstStart = firstStart;
+    newOp.windowSize = windowSize;
+    newOp.numberWindows = numberWindows;
+}
+
+template <WindowAggregate aggregate>
+std::ostream& OpWindowAggregate<aggregate>::dumpState(std::ostream& os) const {
+    os << getOpName() << "(value=" << this->getViewIfDefined()
+       << ", firstStart=" << firstStart << ", windowSize=" << windowSize
+       << ", numberWindows=" << numberWindows << ",\noperand=";
+    return this->operand->dumpState(os) << ")";
+}
+
+template <WindowAggregate aggregate>
+string OpWindowAggregate<aggregate>::getOpName() const {
+    switch (aggregate) {
+        case WindowAggregate::SUM:
+            return "OpWindowSum";
+        case WindowAggregate::MIN:
+            return "OpWindowMin";
+        case WindowAggregate::MAX:
+            return "OpWindowMax";
+    }
+    shouldNotBeCalledPanic;
+}
+
+template <WindowAggregate aggregate>
+void OpWindowAggregate<aggregate>::debugSanityCheckImpl() const {
+    this->operand->debugSanityCheck();
+    auto& members = this->template getMembers<IntView>();
+    sanityEqualsCheck(numberWindows, members.size());
+    UInt fitting = numberFitting(*this->operand->view());
+    for (UInt window = 0; window < members.size(); window++) {
+        auto& member = static_cast<const WindowValue&>(*members[window]);
+        sanityEqualsCheck(window, member.index);
+        bool windowFits = window < fitting;
+        sanityEqualsCheck(windowFits, member.appearsDefined());
+        if (window < fitting) {
+            sanityEqualsCheck(calcWindow(window), member.value);
+        }
+    }
+    this->standardSanityChecksForThisType();
+}
+
+template <typename Op>
+struct OpMaker;
+
+template <WindowAggregate aggregate>
+struct OpMaker<OpWindowAggregate<aggregate>> {
+    static ExprRef<SequenceView> make(ExprRef<SequenceView> sequence,
+                                      UInt firstStart, UInt windowSize,
+                                      UInt numberWindows);
+};
+
+template <WindowAggregate aggregate>
+ExprRef<SequenceView> OpMaker<OpWindowAggregate<aggregate>>::make(
+    ExprRef<SequenceView> sequence, UInt firstStart, UInt windowSize,
+    UInt numberWindows) {
+    auto op = make_shared<OpWindowAggregate<aggregate>>(move(sequence));
+    op->firstStart = firstStart;
+    op->windowSize = windowSize;
+    op->numberWindows = numberWindows;
+    return op;
+}
+
+template struct OpWindowAggregate<WindowAggregate::SUM>;
+template struct OpMaker<OpWindowAggregate<WindowAggregate::SUM>>;
+template struct OpWindowAggregate<WindowAggregate::MIN>;
+template struct OpMaker<OpWindowAggregate<WindowAggregate::MIN>>;
+template struct OpWindowAggregate<WindowAggregate::MAX>;
+template struct OpMaker<OpWindowAggregate<WindowAggregate::MAX>>;
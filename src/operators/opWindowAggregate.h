@@ -0,0 +1,88 @@
+
+#ifndef SRC_OPERATORS_OPWINDOWAGGREGATE_H_
+#define SRC_OPERATORS_OPWINDOWAGGREGATE_H_
+#include <algorithm>
+
+#include "operators/ownedIntValue.h"
+#include "operators/simpleOperator.h"
+#include "types/int.h"
+#include "types/sequence.h"
+
+enum class WindowAggregate { SUM, MIN, MAX };
+
+// a sequence of ints, member k is the sum, min or max of the windowSize
+// operand members starting at zero based index firstStart + k.  The operand
+// is a sequence value of ints.  Not parsed directly, the optimiser produces it as
+// the container of quantifiers of the form
+// [sum([s[j] | j : int(i + a..i + b)]) | i : int(l..u)], so that the windows
+// are folded by sliding over the operand rather than by one unrolled sum per
+// window.  Windows running past the end of the operand are undefined
+// members, as the folds over them would be.
+template <WindowAggregate aggregate>
+struct OpWindowAggregate;
+template <WindowAggregate aggregate>
+struct OperatorTrates<OpWindowAggregate<aggregate>> {
+    class OperandTrigger;
+};
+
+template <WindowAggregate aggregate>
+struct OpWindowAggregate
+    : public SimpleUnaryOperator<SequenceView, SequenceView,
+                                 OpWindowAggregate<aggregate>> {
+    // the members of this op, index is the window.
+    typedef OwnedIntValue<OpWindowAggregate<aggregate>> WindowValue;
+    UInt firstStart = 0;
+    UInt windowSize = 1;
+    UInt numberWindows = 0;
+
+    OpWindowAggregate(ExprRef<SequenceView> operand)
+        : SimpleUnaryOperator<SequenceView, SequenceView,
+                              OpWindowAggregate<aggregate>>(
+              std::move(operand)) {
+        this->members.template emplace<ExprRefVec<IntView>>();
+    }
+    OpWindowAggregate(OpWindowAggregate&&) = delete;
+
+    // the number of windows, from the first, that the operand can fill.
+    inline UInt numberFitting(const SequenceView& operandView) const {
+        UInt size = operandView.numberElements();
+        if (size < firstStart + windowSize) {
+            return 0;
+        }
+        return std::min<UInt>(size - firstStart - windowSize + 1,
+                              numberWindows);
+    }
+    Int calcWindow(UInt window) const;
+    // set windows [first, last), all of which must fit, in
+    // O(last - first + windowSize) by sliding over the operand, a running
+    // total for sums and a monotone deque of candidates for min and max.
+    void setWindowValues(UInt first, UInt last, bool trigger);
+    // recompute windows [first, last) and define or undefine those whose fit
+    // has changed, notifying parents.
+    void updateWindows(UInt first, UInt last);
+    // called with the range of operand members whose values have changed.
+    void operandMembersChanged(UInt start, UInt end);
+    // called after a member is inserted into or removed from the operand,
+    // later windows are shifted along rather than recomputed.
+    void operandMemberAdded(UInt index);
+    void operandMemberRemoved(UInt index);
+    ExprRef<IntView> makeWindowValue(UInt window);
+    void renumberWindows(UInt from);
+    // forwards violations on a window to the operand members in it.
+    void updateOwnedValueViolations(UInt window,
+                                    const ViolationContext& vioContext,
+                                    ViolationContainer& vioContainer);
+
+    void reevaluateImpl(SequenceView& operandView);
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final;
+    void copy(OpWindowAggregate& newOp) const;
+    std::ostream& dumpState(std::ostream& os) const final;
+    std::string getOpName() const final;
+    void debugSanityCheckImpl() const final;
+};
+
+typedef OpWindowAggregate<WindowAggregate::SUM> OpWindowSum;
+typedef OpWindowAggregate<WindowAggregate::MIN> OpWindowMin;
+typedef OpWindowAggregate<WindowAggregate::MAX> OpWindowMax;
+#endif /* SRC_OPERATORS_OPWINDOWAGGREGATE_H_ */
@@ -98,6 +98,19 @@ struct OpMaker<OpSequenceSize> {
     static ExprRef<IntView> make(ExprRef<SequenceView> o);
 };
 
+struct OpCount;
+template <>
+struct OpMaker<OpCount> {
+    static ExprRef<IntView> make(ExprRef<SequenceView> o);
+};
+
+struct OpLinear;
+template <>
+struct OpMaker<OpLinear> {
+    static ExprRef<IntView> make(ExprRef<SequenceView> terms,
+                                 std::vector<Int> coefficients, Int constant);
+};
+
 struct OpSubsetEq;
 template <>
 struct OpMaker<OpSubsetEq> {
@@ -170,6 +183,26 @@ struct OpMaker<IntRange> {
     static ExprRef<SequenceView> make(ExprRef<IntView> l, ExprRef<IntView> r);
 };
 
+enum class WindowAggregate;
+template <WindowAggregate aggregate>
+struct OpWindowAggregate;
+template <WindowAggregate aggregate>
+struct OpMaker<OpWindowAggregate<aggregate>> {
+    static ExprRef<SequenceView> make(ExprRef<SequenceView> sequence,
+                                      UInt firstStart, UInt windowSize,
+                                      UInt numberWindows);
+};
+
+enum class PartitionAggregate;
+template <PartitionAggregate aggregate>
+struct OpPartitionAggregate;
+template <PartitionAggregate aggregate>
+struct OpMaker<OpPartitionAggregate<aggregate>> {
+    static ExprRef<SequenceView> make(ExprRef<PartitionView> partition,
+                                      ExprRef<IntView> term,
+                                      UInt64 termIterId);
+};
+
 struct EnumRange;
 template <>
 struct OpMaker<EnumRange> {
@@ -251,10 +284,39 @@ template <typename SequenceInnerType>
 struct OpMaker<OpFlattenOneLevel<SequenceInnerType>> {
     static ExprRef<SequenceView> make(ExprRef<SequenceView> o);
 };
+template <bool strict>
+struct OpLex;
+typedef OpLex<true> OpLexLess;
+typedef OpLex<false> OpLexLessEq;
+
+template <bool strict>
+struct OpMaker<OpLex<strict>> {
+    static ExprRef<BoolView> make(ExprRef<SequenceView> l,
+                                  ExprRef<SequenceView> r);
+};
+
+struct OpTable;
+template <>
+struct OpMaker<OpTable> {
+    static ExprRef<BoolView> make(ExprRefVec<IntView> operands,
+                                  std::vector<std::vector<Int>> rows);
+};
+
+struct OpGcc;
+template <>
+struct OpMaker<OpGcc> {
+    static ExprRef<BoolView> make(ExprRef<SequenceView> o,
+                                  const std::vector<Int>& values,
+                                  const std::vector<UInt>& lowerBounds,
+                                  const std::vector<UInt>& upperBounds);
+};
+
 struct OpAllDiff;
 template <>
 struct OpMaker<OpAllDiff> {
-    static ExprRef<BoolView> make(ExprRef<SequenceView>);
+    static ExprRef<BoolView> make(
+        ExprRef<SequenceView>,
+        const std::shared_ptr<SequenceDomain>& operandDomain = nullptr);
 };
 struct OpDiv;
 
@@ -301,6 +363,16 @@ template <>
 struct OpMaker<OpSetIntersect> {
     static ExprRef<SetView> make(ExprRef<SetView> l, ExprRef<SetView> r);
 };
+struct OpSetUnion;
+template <>
+struct OpMaker<OpSetUnion> {
+    static ExprRef<SetView> make(ExprRef<SetView> l, ExprRef<SetView> r);
+};
+struct OpSetDifference;
+template <>
+struct OpMaker<OpSetDifference> {
+    static ExprRef<SetView> make(ExprRef<SetView> l, ExprRef<SetView> r);
+};
 struct OpFunctionLitBasic;
 template <>
 struct OpMaker<OpFunctionLitBasic> {
@@ -327,6 +399,23 @@ struct OpMaker<OpMsetSubsetEq> {
     static ExprRef<BoolView> make(ExprRef<MSetView> l, ExprRef<MSetView> r);
 };
 
+template <bool isUnion>
+struct OpMSetUnionIntersect;
+typedef OpMSetUnionIntersect<true> OpMSetUnion;
+typedef OpMSetUnionIntersect<false> OpMSetIntersect;
+template <bool isUnion>
+struct OpMaker<OpMSetUnionIntersect<isUnion>> {
+    static ExprRef<MSetView> make(ExprRef<MSetView> l, ExprRef<MSetView> r);
+};
+
+template <typename OperandView>
+struct OpMSetFreq;
+template <typename OperandView>
+struct OpMaker<OpMSetFreq<OperandView>> {
+    static ExprRef<IntView> make(ExprRef<MSetView> mSet,
+                                 ExprRef<OperandView> operand);
+};
+
 template <typename OperandView>
 struct OpFunctionPreimage;
 
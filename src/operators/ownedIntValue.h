@@ -0,0 +1,40 @@
+#ifndef SRC_OPERATORS_OWNEDINTVALUE_H_
+#define SRC_OPERATORS_OWNEDINTVALUE_H_
+#include "types/int.h"
+
+// an int member of a sequence operator that computes its members itself,
+// such as the windows of OpWindowAggregate.  The owner sets value and
+// notifies on its behalf, so the member never evaluates, triggers, copies or
+// optimises on its own.  index identifies the member to the owner, which
+// keeps it up to date, and violations on the member are passed back through
+// Owner::updateOwnedValueViolations.
+template <typename Owner>
+struct OwnedIntValue : public IntView {
+    Owner* owner;
+    UInt index;
+    OwnedIntValue(Owner* owner, UInt index) : owner(owner), index(index) {}
+    void evaluateImpl() final {}
+    void startTriggeringImpl() final {}
+    void stopTriggering() final {}
+    void updateVarViolationsImpl(const ViolationContext& vioContext,
+                                 ViolationContainer& vioContainer) final {
+        owner->updateOwnedValueViolations(index, vioContext, vioContainer);
+    }
+    ExprRef<IntView> deepCopyForUnrollImpl(const ExprRef<IntView>& self,
+                                           const AnyIterRef&) const final {
+        return self;
+    }
+    std::ostream& dumpState(std::ostream& os) const final {
+        return os << owner->getOpName() << "[" << index << "]=" << value;
+    }
+    void findAndReplaceSelf(const FindAndReplaceFunction&,
+                            PathExtension) final {}
+    std::pair<bool, ExprRef<IntView>> optimiseImpl(ExprRef<IntView>& self,
+                                                   PathExtension) final {
+        return std::make_pair(false, self);
+    }
+    std::string getOpName() const final { return "OwnedIntValue"; }
+    void debugSanityCheckImpl() const final {}
+};
+
+#endif /* SRC_OPERATORS_OWNEDINTVALUE_H_ */
@@ -4,57 +4,176 @@
 #include <cassert>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
 #include "common/common.h"
 
+/* Positional cache of operand values, indexed in the same way as the operands
+ * of a sequence folding operator.  Values are stored in consecutive blocks of
+ * bounded size.  A Fenwick tree over the block sizes maps a position to its
+ * block in O(log n), so inserting or erasing at an interior position costs a
+ * bounded memmove within one block rather than a shift of the entire cache.
+ * Whilst everything fits in one block, lookups index the block directly.*/
 template <typename Value>
 struct PreviousValueCache {
-    std::vector<Value> contents;
+   private:
+    static const size_t MAX_BLOCK_SIZE = 512;
+    std::vector<std::vector<Value>> blocks;
+    // 1 based Fenwick tree over blocks[i].size()
+    std::vector<size_t> blockSizeTree;
+    size_t highestTreeStep = 0;
+    size_t totalSize = 0;
+
+    void rebuildBlockSizeTree() {
+        blockSizeTree.assign(blocks.size() + 1, 0);
+        for (size_t i = 1; i < blockSizeTree.size(); i++) {
+            blockSizeTree[i] += blocks[i - 1].size();
+            size_t parent = i + (i & -i);
+            if (parent < blockSizeTree.size()) {
+                blockSizeTree[parent] += blockSizeTree[i];
+            }
+        }
+        highestTreeStep = 1;
+        while (highestTreeStep * 2 <= blocks.size()) {
+            highestTreeStep *= 2;
+        }
+    }
+
+    void addToBlockSize(size_t blockIndex, int delta) {
+        for (size_t i = blockIndex + 1; i < blockSizeTree.size();
+             i += (i & -i)) {
+            blockSizeTree[i] += delta;
+        }
+    }
+
+    // returns the block containing index and the offset of index within that
+    // block.
+    inline std::pair<size_t, size_t> locate(size_t index) const {
+        if (blocks.size() == 1) {
+            return std::make_pair(0, index);
+        }
+        size_t blockIndex = 0;
+        for (size_t step = highestTreeStep; step > 0; step /= 2) {
+            size_t next = blockIndex + step;
+            if (next < blockSizeTree.size() && blockSizeTree[next] <= index) {
+                blockIndex = next;
+                index -= blockSizeTree[next];
+            }
+        }
+        return std::make_pair(blockIndex, index);
+    }
+
+    void splitBlock(size_t blockIndex) {
+        auto& block = blocks[blockIndex];
+        std::vector<Value> secondHalf(
+            std::make_move_iterator(block.begin() + block.size() / 2),
+            std::make_move_iterator(block.end()));
+        block.erase(block.begin() + block.size() / 2, block.end());
+        blocks.insert(blocks.begin() + blockIndex + 1, std::move(secondHalf));
+        rebuildBlockSizeTree();
+    }
+
+   public:
     template <typename V>
     void set(size_t index, V&& value) {
-        debug_code(assert(index < contents.size()));
-        contents[index] = std::forward<V>(value);
+        get(index) = std::forward<V>(value);
     }
 
     Value& get(size_t index) {
-        debug_code(assert(index < contents.size()));
-        return contents[index];
+        debug_code(assert(index < totalSize));
+        auto location = locate(index);
+        return blocks[location.first][location.second];
     }
-    inline size_t size() const { return contents.size(); }
+    inline size_t size() const { return totalSize; }
     const Value& get(size_t index) const {
-        debug_code(assert(index < contents.size()));
-        return contents[index];
+        debug_code(assert(index < totalSize));
+        auto location = locate(index);
+        return blocks[location.first][location.second];
     }
 
     template <typename V>
     Value getAndSet(size_t index, V&& value) {
-        Value oldValue = get(index);
-        set(index, std::forward<V>(value));
+        Value& cachedValue = get(index);
+        Value oldValue = std::move(cachedValue);
+        cachedValue = std::forward<V>(value);
         return oldValue;
     }
     template <typename V>
     void insert(size_t index, V&& value) {
-        debug_code(assert(index <= contents.size()));
-        contents.insert(contents.begin() + index, std::forward<V>(value));
+        debug_code(assert(index <= totalSize));
+        if (blocks.empty()) {
+            blocks.emplace_back();
+            rebuildBlockSizeTree();
+        }
+        std::pair<size_t, size_t> location =
+            (index == totalSize)
+                ? std::make_pair(blocks.size() - 1, blocks.back().size())
+                : locate(index);
+        auto& block = blocks[location.first];
+        block.insert(block.begin() + location.second, std::forward<V>(value));
+        ++totalSize;
+        addToBlockSize(location.first, 1);
+        if (block.size() > MAX_BLOCK_SIZE) {
+            splitBlock(location.first);
+        }
     }
     Value erase(size_t index) {
-        Value oldValue = get(index);
-        contents.erase(contents.begin() + index);
+        debug_code(assert(index < totalSize));
+        auto location = locate(index);
+        auto& block = blocks[location.first];
+        Value oldValue = std::move(block[location.second]);
+        block.erase(block.begin() + location.second);
+        --totalSize;
+        if (block.empty() && blocks.size() > 1) {
+            blocks.erase(blocks.begin() + location.first);
+            rebuildBlockSizeTree();
+        } else {
+            addToBlockSize(location.first, -1);
+        }
         return oldValue;
     }
 
+    inline void swap(size_t index1, size_t index2) {
+        std::swap(get(index1), get(index2));
+    }
+
     Value swapErase(size_t index) {
-        debug_code(assert(index < contents.size()));
-        std::swap(get(index), get(contents.size() - 1));
-        return erase(contents.size() - 1);
+        debug_code(assert(index < totalSize));
+        swap(index, totalSize - 1);
+        return erase(totalSize - 1);
+    }
+    void clear() {
+        blocks.clear();
+        blockSizeTree.clear();
+        highestTreeStep = 0;
+        totalSize = 0;
+    }
+
+    template <typename Func>
+    void forEach(Func&& func) const {
+        for (auto& block : blocks) {
+            for (auto& value : block) {
+                func(value);
+            }
+        }
     }
-    void clear() { contents.clear(); }
     inline bool operator==(const PreviousValueCache<Value>& other) const {
-        return contents == other.contents;
+        if (totalSize != other.totalSize) {
+            return false;
+        }
+        for (size_t i = 0; i < totalSize; i++) {
+            if (!(get(i) == other.get(i))) {
+                return false;
+            }
+        }
+        return true;
     }
     friend inline std::ostream& operator<<(
         std::ostream& os, const PreviousValueCache<Value>& other) {
-        return os << other.contents;
+        std::vector<Value> contents;
+        contents.reserve(other.size());
+        other.forEach([&](const Value& value) { contents.push_back(value); });
+        return os << contents;
     }
 };
 #endif /* SRC_OPERATORS_PREVIOUSVALUECACHE_H_ */
@@ -143,6 +143,97 @@ bool tryPromotingSubExpressionsToConditions(Quant&, ExprRef<View>&,
     return false;
 }
 
+lib::optional<AnyExprRef> getQuantifierContainer(const AnyExprRef& expr) {
+    auto sequenceTest = lib::get_if<ExprRef<SequenceView>>(&expr);
+    if (!sequenceTest) {
+        return lib::nullopt;
+    }
+    auto setQuantTest = getAs<Quantifier<SetView>>(*sequenceTest);
+    if (setQuantTest) {
+        return AnyExprRef(setQuantTest->container);
+    }
+    auto msetQuantTest = getAs<Quantifier<MSetView>>(*sequenceTest);
+    if (msetQuantTest) {
+        return AnyExprRef(msetQuantTest->container);
+    }
+    auto sequenceQuantTest = getAs<Quantifier<SequenceView>>(*sequenceTest);
+    if (sequenceQuantTest) {
+        return AnyExprRef(sequenceQuantTest->container);
+    }
+    auto functionQuantTest = getAs<Quantifier<FunctionView>>(*sequenceTest);
+    if (functionQuantTest) {
+        return AnyExprRef(functionQuantTest->container);
+    }
+    return lib::nullopt;
+}
+
+// true if an iterator of quantId can be reached from expr.  visited holds
+// the answer for every node already seen, templates may share nodes.  If
+// expr is copied when unrolling, that is it depends on the iterator or is a
+// template root, the quantifiers among its operands are added to dependents
+// too.  A quantifier holds state for its parent, such as its folding parent,
+// so it is never shared by the copies of its parent.
+static bool findIteratorDependents(const AnyExprRef& expr, UInt64 quantId,
+                                   HashMap<const void*, bool>& visited,
+                                   HashSet<const void*>& dependents,
+                                   bool isRoot) {
+    return lib::visit(
+        [&](auto& expr) {
+            typedef viewType(expr) View;
+            const void* address = &(*expr);
+            auto visitedTest = visited.find(address);
+            if (visitedTest != visited.end()) {
+                return visitedTest->second;
+            }
+            bool depends = false;
+            auto iteratorTest = getAs<Iterator<View>>(expr);
+            if (iteratorTest) {
+                depends = iteratorTest->id == quantId;
+            } else if (!expr->isConstant()) {
+                vector<AnyExprRef> operands;
+                FindAndReplaceFunction findInOperand =
+                    [&](AnyExprRef operand,
+                        const PathExtension&) -> pair<bool, AnyExprRef> {
+                    depends |= findIteratorDependents(
+                        operand, quantId, visited, dependents, false);
+                    operands.emplace_back(operand);
+                    return make_pair(true, operand);
+                };
+                expr->findAndReplaceSelf(findInOperand,
+                                         PathExtension::begin());
+                auto containerTest = getQuantifierContainer(expr);
+                if (containerTest) {
+                    depends |= findIteratorDependents(
+                        *containerTest, quantId, visited, dependents, false);
+                    operands.emplace_back(move(*containerTest));
+                }
+                if (depends || isRoot) {
+                    for (auto& operand : operands) {
+                        lib::visit(
+                            [&](auto& operand) {
+                                if (operand->isQuantifier()) {
+                                    dependents.insert(&(*operand));
+                                }
+                            },
+                            operand);
+                    }
+                }
+            }
+            visited.emplace(address, depends);
+            if (depends) {
+                dependents.insert(address);
+            }
+            return depends;
+        },
+        expr);
+}
+
+void findIteratorDependents(const AnyExprRef& expr, UInt64 quantId,
+                            HashSet<const void*>& dependents) {
+    HashMap<const void*, bool> visited;
+    findIteratorDependents(expr, quantId, visited, dependents, true);
+}
+
 bool areAllConstant(const ExprRefVec<IntView>& exprs) {
     for (const auto& expr : exprs) {
         if (!expr->isConstant()) {
@@ -279,6 +370,26 @@ template <>
 bool optimiseIfCanBeConvertedToSubstringQuantifier<SequenceView>(
     Quantifier<SequenceView>& quant);
 
+template <typename View>
+bool optimiseIfCanBeConvertedToWindowAggregate(Quantifier<View>&) {
+    return false;
+}
+
+template <>
+bool optimiseIfCanBeConvertedToWindowAggregate<SequenceView>(
+    Quantifier<SequenceView>& quant);
+
+template <typename View>
+lib::optional<ExprRef<SequenceView>>
+optimiseIfCanBeConvertedToPartitionAggregate(Quantifier<View>&) {
+    return lib::nullopt;
+}
+
+template <>
+lib::optional<ExprRef<SequenceView>>
+optimiseIfCanBeConvertedToPartitionAggregate<SetView>(
+    Quantifier<SetView>& quant);
+
 template <typename View>
 bool optimiseIfIndicesAreNotUsedInSequenceQuantifier(Quantifier<View>&) {
     return false;
@@ -308,7 +419,13 @@ pair<bool, ExprRef<SequenceView>> Quantifier<ContainerType>::optimiseImpl(
         newOp->expr);
     optimised |= optimiseIfIntRangeWithConditions(*newOp);
     optimised |= optimiseIfCanBeConvertedToSubstringQuantifier(*newOp);
+    optimised |= optimiseIfCanBeConvertedToWindowAggregate(*newOp);
     optimised |= optimiseIfIndicesAreNotUsedInSequenceQuantifier(*newOp);
+    auto partitionAggregate =
+        optimiseIfCanBeConvertedToPartitionAggregate(*newOp);
+    if (partitionAggregate) {
+        return make_pair(true, *partitionAggregate);
+    }
     return make_pair(optimised, newOpAsExpr);
 }
 
@@ -13,6 +13,16 @@ inline static UInt64 nextQuantId() {
 template <typename Container>
 struct ContainerTrigger;
 
+// the container of expr if it is a quantifier, findAndReplace does not enter
+// the containers of quantifiers.
+lib::optional<AnyExprRef> getQuantifierContainer(const AnyExprRef& expr);
+
+// add to dependents the nodes of expr from which an iterator of the
+// quantifier quantId can be reached.  Containers of nested quantifiers are
+// included, as are nested quantifiers whose parent is a dependent.
+void findIteratorDependents(const AnyExprRef& expr, UInt64 quantId,
+                            HashSet<const void*>& dependents);
+
 template <typename View, EnableIfView<View> = 0>
 struct QueuedUnrollValue {
     bool directUnrollExpr = false;  // if true, when unrolling unrollExpr() will
@@ -23,13 +33,52 @@ struct QueuedUnrollValue {
         : directUnrollExpr(directUnrollExpr), index(index), value(value) {}
 };
 
+/* A folding operator (sum, and, ...) whose operand is a quantifier may fuse
+ * with it.  The quantifier then reports a change to one of its unrolled exprs
+ * straight to the operator instead of notifying a subsequence change through
+ * its sequence triggers.  The quantifier's trigger on each unrolled expr also
+ * keeps the value that the operator last folded in for that expr, so the
+ * operator needs no positional cache of its own.  Unrolling, rolling and
+ * swapping exprs is still notified through the sequence triggers.*/
+struct FoldingParent {
+    virtual ~FoldingParent() {}
+    // the value to fold in for the unrolled expr at index in its current
+    // state.
+    virtual Int foldValueOf(UInt index) = 0;
+    // the unrolled expr at index has changed value, foldedValue should be
+    // updated to the value now folded in.
+    virtual void unrolledExprChanged(UInt index, Int& foldedValue) = 0;
+    // the quantifier is no longer fused with this parent.  The numberFolded
+    // folded values are still readable so that the parent can cache them
+    // itself.
+    virtual void unfused(UInt numberFolded) = 0;
+};
+
+// the parts of a quantifier that do not depend on the container type.
+struct QuantifierBase {
+    FoldingParent* foldingParent = nullptr;
+    virtual ~QuantifierBase() {}
+    // the value the folding parent last folded in for the unrolled expr at
+    // index, only available whilst triggering.
+    virtual Int& foldedValue(UInt index) = 0;
+    // fuse with parent, which must already be triggering on this quantifier.
+    // Only done if parent's trigger is the only trigger on this quantifier,
+    // other parents would otherwise miss changes to the unrolled exprs.
+    // Returns true if fused.
+    virtual bool fuseWith(FoldingParent& parent) = 0;
+    // if fused with parent, stop fusing and let parent know.
+    virtual void unfuse(FoldingParent& parent) = 0;
+};
+
 template <typename ContainerType>
-struct Quantifier : public SequenceView {
+struct Quantifier : public SequenceView, public QuantifierBase {
     // for each expr or condition that is unrolled, this class is used as the
     // base class for triggers on that expr/condition
     struct ExprTriggerBase : public virtual TriggerBase {
         Quantifier<ContainerType>* op;
         UInt index;
+        // see FoldingParent
+        Int foldedValue = 0;
         ExprTriggerBase(Quantifier<ContainerType>* op, UInt index)
             : op(op), index(index) {}
         virtual ~ExprTriggerBase() {}
@@ -75,11 +124,16 @@ struct Quantifier : public SequenceView {
     bool optimisedToNotUpdateIndices =
         false;  // when quantifying over a sequence and the index of each
                 // element is not used.
+    // the nodes of the expr and condition templates that depend on the
+    // iterator, see Iterator::unrollDependents.  Found on the first unroll.
+    HashSet<const void*> unrollDependents;
+    bool unrollDependentsFound = false;
     Quantifier(ExprRef<ContainerType> container,
                const UInt64 id = nextQuantId())
         : quantId(id), container(std::move(container)) {}
     inline void setExpression(AnyExprRef exprIn) {
         expr = std::move(exprIn);
+        unrollDependentsFound = false;
         lib::visit(
             [&](auto& expr) { members.emplace<ExprRefVec<viewType(expr)>>(); },
             expr);
@@ -87,6 +141,7 @@ struct Quantifier : public SequenceView {
 
     inline void setCondition(const ExprRef<BoolView>& condition) {
         this->condition = condition;
+        unrollDependentsFound = false;
     }
     ~Quantifier() { this->stopTriggeringOnChildren(); }
     void evaluateImpl() final;
@@ -99,12 +154,16 @@ struct Quantifier : public SequenceView {
         const ExprRef<SequenceView>&, const AnyIterRef& iterator) const final;
     std::ostream& dumpState(std::ostream& os) const final;
     bool isQuantifier() const final;
+    // a second trigger ends any fusion, see FoldingParent.
+    void addTriggerImpl(const std::shared_ptr<SequenceTrigger>& trigger,
+                        bool includeMembers, Int memberIndex) final;
     template <typename T>
     inline IterRef<T> newIterRef() {
         return std::make_shared<Iterator<T>>(quantId, nullptr);
     }
 
     bool triggering();
+    const HashSet<const void*>& getUnrollDependents();
 
     UInt numberUnrolled() const {
         // if quantifier has conditions, number unrolled is the number of
@@ -138,6 +197,11 @@ struct Quantifier : public SequenceView {
     void stopTriggeringOnCondition(UInt oldIndex, UnrolledCondition& condition);
 
     void findAndReplaceSelf(const FindAndReplaceFunction&, PathExtension) final;
+    inline Int& foldedValue(UInt index) final {
+        return exprTriggers[index]->foldedValue;
+    }
+    bool fuseWith(FoldingParent& parent) final;
+    void unfuse(FoldingParent& parent) final;
 
     std::pair<bool, ExprRef<SequenceView>> optimiseImpl(
         ExprRef<SequenceView>& self, PathExtension path);
@@ -52,11 +52,63 @@ bool Quantifier<ContainerType>::triggering() {
     return static_cast<bool>(containerTrigger);
 }
 
+template <typename ContainerType>
+const HashSet<const void*>& Quantifier<ContainerType>::getUnrollDependents() {
+    if (!unrollDependentsFound) {
+        unrollDependents.clear();
+        findIteratorDependents(expr, quantId, unrollDependents);
+        if (condition) {
+            findIteratorDependents(condition, quantId, unrollDependents);
+        }
+        // the unrolled exprs and conditions must still be distinct members.
+        lib::visit([&](auto& expr) { unrollDependents.insert(&(*expr)); },
+                   expr);
+        if (condition) {
+            unrollDependents.insert(&(*condition));
+        }
+        unrollDependentsFound = true;
+    }
+    return unrollDependents;
+}
+
 template <typename ContainerType>
 bool Quantifier<ContainerType>::isQuantifier() const {
     return true;
 }
 
+template <typename ContainerType>
+bool Quantifier<ContainerType>::fuseWith(FoldingParent& parent) {
+    debug_code(assert(foldingParent == nullptr || foldingParent == &parent));
+    if (!triggering() || triggers.numberActive() != 1) {
+        return false;
+    }
+    foldingParent = &parent;
+    // the exprs were unrolled before fusing.
+    for (size_t i = 0; i < exprTriggers.size(); i++) {
+        exprTriggers[i]->foldedValue = parent.foldValueOf(i);
+    }
+    return true;
+}
+
+template <typename ContainerType>
+void Quantifier<ContainerType>::unfuse(FoldingParent& parent) {
+    if (foldingParent == &parent) {
+        foldingParent = nullptr;
+        parent.unfused(exprTriggers.size());
+    }
+}
+
+template <typename ContainerType>
+void Quantifier<ContainerType>::addTriggerImpl(
+    const std::shared_ptr<SequenceTrigger>& trigger, bool includeMembers,
+    Int memberIndex) {
+    if (foldingParent) {
+        unfuse(*foldingParent);
+    }
+    ExprInterface<SequenceView>::addTriggerImpl(trigger, includeMembers,
+                                                memberIndex);
+}
+
 template <typename View1, typename View2>
 ExprRef<View1> deepCopyExprAndAssignNewValue(ExprRef<View1> exprToCopy,
                                              ExprRef<View2> newValue,
@@ -140,6 +192,7 @@ template <typename ContainerType>
 template <typename View>
 void Quantifier<ContainerType>::unroll(QueuedUnrollValue<View> queuedValue) {
     auto newIter = this->newIterRef<View>();
+    newIter->unrollDependents = &getUnrollDependents();
     if (!queuedValue.directUnrollExpr) {
         unrolledIterVals.insert(unrolledIterVals.begin() + queuedValue.index,
                                 newIter);
@@ -151,6 +204,7 @@ void Quantifier<ContainerType>::unroll(QueuedUnrollValue<View> queuedValue) {
             queuedValue.index, queuedValue.value, newIter);
         if (unrolledCondition.cachedValue) {
             auto tempNewIter = this->newIterRef<View>();
+            tempNewIter->unrollDependents = newIter->unrollDependents;
             unrollExpr(unrolledCondition.exprIndex, queuedValue.value,
                        tempNewIter);
             newIter->moveTriggersFrom(*tempNewIter);
@@ -381,6 +435,9 @@ void Quantifier<ContainerType>::startTriggeringOnExpr(UInt index,
     for (size_t i = index + 1; i < exprTriggers.size(); i++) {
         exprTriggers[i]->index = i;
     }
+    if (foldingParent) {
+        trigger->foldedValue = foldingParent->foldValueOf(index);
+    }
     expr->addTrigger(trigger);
 }
 
@@ -457,6 +514,9 @@ void Quantifier<ContainerType>::stopTriggeringOnChildren() {
 
 template <typename ContainerType>
 void Quantifier<ContainerType>::stopTriggering() {
+    if (foldingParent) {
+        unfuse(*foldingParent);
+    }
     if (containerTrigger) {
         stopTriggeringOnChildren();
         lib::visit(
@@ -566,6 +626,10 @@ void Quantifier<ContainerType>::debugSanityCheckImpl() const {
         return;
     }
     standardSanityChecksForThisType();
+    if (foldingParent) {
+        sanityCheck(triggers.numberActive() == 1,
+                    "Quantifier fused with a parent should have one trigger.");
+    }
     ContainerSanityChecker<viewType(container)>::debugSanityCheck(*this, *view);
     UInt checkNumberUndefined = 0;
     lib::visit(
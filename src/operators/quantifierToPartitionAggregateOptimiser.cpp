@@ -0,0 +1,205 @@
+#include <vector>
+
+#include "operators/opMinMax.h"
+#include "operators/opPartitionAggregate.h"
+#include "operators/opPartitionParts.h"
+#include "operators/opSetSize.h"
+#include "operators/opSum.h"
+#include "operators/opTupleIndex.h"
+#include "operators/operatorMakers.h"
+#include "operators/quantifier.h"
+#include "triggers/allTriggers.h"
+#include "types/allTypes.h"
+#include "types/intVal.h"
+
+using namespace std;
+
+namespace PartitionAggregateDetail {
+
+// a sum, min or max found in the body of a quantifier over parts(P), whose
+// operand is the quantifier [w(i) | i <- p] with p the iterator over the
+// parts.  |p| is a sum with w(i) = 1.
+struct PartFold {
+    PartitionAggregate aggregate;
+    const void* foldOp;
+    ExprRef<IntView> term;
+    UInt64 termIterId;
+};
+
+bool isPartIterator(UInt64 partIterId, const ExprRef<SetView>& expr) {
+    auto iterTest = getAs<Iterator<SetView>>(expr);
+    return iterTest && iterTest->id == partIterId;
+}
+
+// true if term refers to nothing but the iterator termIterId and constants,
+// so that its value is fixed by the value of the iterator.
+bool isWeightTerm(UInt64 termIterId, ExprRef<IntView> term) {
+    bool weightTerm = true;
+    FindAndReplaceFunction checker =
+        [&](AnyExprRef expr, const PathExtension&) -> pair<bool, AnyExprRef> {
+        bool constant = lib::visit(
+            [&](auto& expr) {
+                typedef viewType(expr) View;
+                auto iterTest = getAs<Iterator<View>>(expr);
+                if (iterTest) {
+                    weightTerm &= iterTest->id == termIterId;
+                } else if (!expr->isConstant() &&
+                           dynamic_cast<const ValBase*>(&(*expr))) {
+                    weightTerm = false;
+                }
+                return expr->isConstant();
+            },
+            expr);
+        weightTerm &= !getQuantifierContainer(expr).has_value();
+        return make_pair(constant || !weightTerm, expr);
+    };
+    findAndReplace(term, checker);
+    return weightTerm;
+}
+
+lib::optional<PartFold> getIfPartFold(UInt64 partIterId, const void* foldOp,
+                                      const ExprRef<SequenceView>& operand,
+                                      PartitionAggregate aggregate) {
+    auto quantTest = getAs<Quantifier<SetView>>(operand);
+    if (!quantTest || quantTest->condition ||
+        !isPartIterator(partIterId, quantTest->container)) {
+        return lib::nullopt;
+    }
+    auto termTest = lib::get_if<ExprRef<IntView>>(&quantTest->expr);
+    if (!termTest || !isWeightTerm(quantTest->quantId, *termTest)) {
+        return lib::nullopt;
+    }
+    return PartFold{aggregate, foldOp, *termTest, quantTest->quantId};
+}
+
+lib::optional<PartFold> getIfPartFold(UInt64 partIterId,
+                                      const ExprRef<IntView>& expr) {
+    auto sumTest = getAs<OpSum>(expr);
+    if (sumTest) {
+        return getIfPartFold(partIterId, &(*sumTest), sumTest->operand,
+                             PartitionAggregate::SUM);
+    }
+    auto minTest = getAs<OpMin>(expr);
+    if (minTest) {
+        return getIfPartFold(partIterId, &(*minTest), minTest->operand,
+                             PartitionAggregate::MIN);
+    }
+    auto maxTest = getAs<OpMax>(expr);
+    if (maxTest) {
+        return getIfPartFold(partIterId, &(*maxTest), maxTest->operand,
+                             PartitionAggregate::MAX);
+    }
+    auto sizeTest = getAs<OpSetSize>(expr);
+    if (sizeTest && isPartIterator(partIterId, sizeTest->operand)) {
+        auto one = make<IntValue>();
+        one->value = 1;
+        one->setConstant(true);
+        return PartFold{PartitionAggregate::SUM, &(*sizeTest), one.asExpr(),
+                        0};
+    }
+    return lib::nullopt;
+}
+
+ExprRef<SequenceView> makePartitionAggregate(
+    const PartFold& fold, const ExprRef<PartitionView>& partition) {
+    switch (fold.aggregate) {
+        case PartitionAggregate::SUM:
+            return OpMaker<OpPartitionSum>::make(partition, fold.term,
+                                                 fold.termIterId);
+        case PartitionAggregate::MIN:
+            return OpMaker<OpPartitionMin>::make(partition, fold.term,
+                                                 fold.termIterId);
+        case PartitionAggregate::MAX:
+            return OpMaker<OpPartitionMax>::make(partition, fold.term,
+                                                 fold.termIterId);
+    }
+    shouldNotBeCalledPanic;
+}
+}  // namespace PartitionAggregateDetail
+
+// rewrite [f(sum([w(i) | i <- p])) | p <- parts(P)], with w(i) referring to
+// nothing but i and constants, to [f(s) | s <- OpPartitionSum(P)], likewise
+// for min, max and |p|.  Moving members between parts then updates the folds
+// of the parts involved instead of the sets yielded by parts(P).  The
+// container type changes, so the new quantifier is returned.
+template <typename View>
+lib::optional<ExprRef<SequenceView>>
+optimiseIfCanBeConvertedToPartitionAggregate(Quantifier<View>&);
+template <>
+lib::optional<ExprRef<SequenceView>>
+optimiseIfCanBeConvertedToPartitionAggregate<SetView>(
+    Quantifier<SetView>& quant) {
+    using namespace PartitionAggregateDetail;
+    auto partsTest = getAs<OpPartitionParts>(quant.container);
+    if (!partsTest || quant.condition) {
+        return lib::nullopt;
+    }
+    lib::optional<PartFold> fold;
+    bool fail = false;
+    FindAndReplaceFunction foldFinder =
+        [&](AnyExprRef expr, const PathExtension&) -> pair<bool, AnyExprRef> {
+        auto intExprTest = lib::get_if<ExprRef<IntView>>(&expr);
+        if (!fail && intExprTest) {
+            auto foldTest = getIfPartFold(quant.quantId, *intExprTest);
+            if (foldTest) {
+                fail = fold.has_value();
+                fold = foldTest;
+                return make_pair(true, expr);
+            }
+        }
+        return make_pair(false, expr);
+    };
+    lib::visit([&](auto& expr) { findAndReplace(expr, foldFinder); },
+               quant.expr);
+    if (fail || !fold) {
+        return lib::nullopt;
+    }
+    // the part may only be used by the fold.
+    size_t numberUses = 0;
+    FindAndReplaceFunction useCounter =
+        [&](AnyExprRef expr, const PathExtension&) -> pair<bool, AnyExprRef> {
+        auto containerTest = getQuantifierContainer(expr);
+        if (containerTest) {
+            lib::visit(
+                [&](auto& container) { findAndReplace(container, useCounter); },
+                *containerTest);
+        }
+        auto setExprTest = lib::get_if<ExprRef<SetView>>(&expr);
+        if (setExprTest && isPartIterator(quant.quantId, *setExprTest)) {
+            ++numberUses;
+        }
+        return make_pair(false, expr);
+    };
+    lib::visit([&](auto& expr) { findAndReplace(expr, useCounter); },
+               quant.expr);
+    if (numberUses != 1) {
+        return lib::nullopt;
+    }
+    auto aggregate = makePartitionAggregate(*fold, partsTest->operand);
+    aggregate->setConstant(quant.container->isConstant());
+    auto newQuant = make_shared<Quantifier<SequenceView>>(aggregate);
+    auto newIterator = newQuant->newIterRef<TupleView>();
+    FindAndReplaceFunction replaceFunc =
+        [&](AnyExprRef expr, const PathExtension&) -> pair<bool, AnyExprRef> {
+        auto intExprTest = lib::get_if<ExprRef<IntView>>(&expr);
+        if (!intExprTest) {
+            return make_pair(false, expr);
+        }
+        auto foldTest = getIfPartFold(quant.quantId, *intExprTest);
+        if (!foldTest || foldTest->foldOp != fold->foldOp) {
+            return make_pair(false, expr);
+        }
+        return make_pair(true, AnyExprRef(OpMaker<OpTupleIndex<IntView>>::make(
+                                   newIterator, 1)));
+    };
+    lib::visit(
+        [&](auto& expr) {
+            newQuant->setExpression(findAndReplace(expr, replaceFunc));
+        },
+        quant.expr);
+    newQuant->setConstant(quant.isConstant());
+    debug_log(
+        "Optimise: rewriting quantifier over folds of partition parts to "
+        "partition aggregate.");
+    return ExprRef<SequenceView>(newQuant);
+}
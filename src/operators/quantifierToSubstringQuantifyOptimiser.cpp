@@ -8,19 +8,23 @@
 #include "operators/opIntEq.h"
 #include "operators/opLess.h"
 #include "operators/opLessEq.h"
+#include "operators/opMinMax.h"
 #include "operators/opMinus.h"
 #include "operators/opProd.h"
 #include "operators/opSequenceIndex.h"
 #include "operators/opSequenceLit.h"
+#include "operators/opSubstringQuantify.h"
 #include "operators/opSum.h"
 #include "operators/opToInt.h"
 #include "operators/opTupleIndex.h"
 #include "operators/opTupleLit.h"
+#include "operators/opWindowAggregate.h"
 #include "operators/operatorMakers.h"
 #include "operators/quantifier.h"
 #include "triggers/allTriggers.h"
 #include "types/allTypes.h"
 #include "types/intVal.h"
+#include "types/sequenceVal.h"
 template <typename View>
 struct OpSubstringQuantify;
 template <typename View>
@@ -351,6 +355,190 @@ bool optimiseIfCanBeConvertedToSubstringQuantifier<SequenceView>(
     return true;
 }
 
+namespace WindowAggregateDetail {
+using namespace SubstringQuantifyDetail;
+
+// a sum, min or max found in the body of a quantifier over an int range,
+// whose operand is the substring quantifier [s[j] | j : int(i + a..i + b)]
+// with i the quantifier's iterator and s a sequence value.
+struct WindowFold {
+    WindowAggregate aggregate;
+    const void* foldOp;
+    ExprRef<SequenceView> sequence;
+    Int lowOffset;
+    Int highOffset;
+};
+
+// true if expr is OpTupleIndex<IntView>(OpTupleIndex<TupleView>(iter, 1), 0)
+// with iter the iterator of the given quantifier, that is the single member
+// of the window yielded by a substring quantifier of window size 1.
+bool isWindowMember(UInt64 iterId, const ExprRef<IntView>& expr) {
+    auto memberTest = getAs<OpTupleIndex<IntView>>(expr);
+    if (!memberTest || memberTest->indexOperand != 0) {
+        return false;
+    }
+    auto windowTest = getIfTupleIndexOverIterator(iterId,
+                                                  memberTest->tupleOperand);
+    return windowTest && windowTest->indexOperand == 1;
+}
+
+lib::optional<WindowFold> getIfWindowFold(UInt64 outerIterId,
+                                          const void* foldOp,
+                                          const ExprRef<SequenceView>& operand,
+                                          WindowAggregate aggregate) {
+    auto quantTest = getAs<Quantifier<SequenceView>>(operand);
+    if (!quantTest || quantTest->condition) {
+        return lib::nullopt;
+    }
+    auto exprTest = lib::get_if<ExprRef<IntView>>(&quantTest->expr);
+    if (!exprTest || !isWindowMember(quantTest->quantId, *exprTest)) {
+        return lib::nullopt;
+    }
+    auto substringTest =
+        getAs<OpSubstringQuantify<IntView>>(quantTest->container);
+    if (!substringTest || substringTest->windowSize != 1 ||
+        !getAs<SequenceValue>(substringTest->sequenceOperand)) {
+        return lib::nullopt;
+    }
+    auto lowOffset =
+        calcIndexOffset(outerIterId, substringTest->lowerBoundOperand);
+    auto highOffset =
+        calcIndexOffset(outerIterId, substringTest->upperBoundOperand);
+    if (!lowOffset || !highOffset || *highOffset < *lowOffset) {
+        return lib::nullopt;
+    }
+    return WindowFold{aggregate, foldOp, substringTest->sequenceOperand,
+                      *lowOffset, *highOffset};
+}
+
+lib::optional<WindowFold> getIfWindowFold(UInt64 outerIterId,
+                                          const ExprRef<IntView>& expr) {
+    auto sumTest = getAs<OpSum>(expr);
+    if (sumTest) {
+        return getIfWindowFold(outerIterId, &(*sumTest), sumTest->operand,
+                               WindowAggregate::SUM);
+    }
+    auto minTest = getAs<OpMin>(expr);
+    if (minTest) {
+        return getIfWindowFold(outerIterId, &(*minTest), minTest->operand,
+                               WindowAggregate::MIN);
+    }
+    auto maxTest = getAs<OpMax>(expr);
+    if (maxTest) {
+        return getIfWindowFold(outerIterId, &(*maxTest), maxTest->operand,
+                               WindowAggregate::MAX);
+    }
+    return lib::nullopt;
+}
+
+ExprRef<SequenceView> makeWindowAggregate(const WindowFold& fold,
+                                          UInt firstStart,
+                                          UInt numberWindows) {
+    UInt windowSize = (fold.highOffset - fold.lowOffset) + 1;
+    switch (fold.aggregate) {
+        case WindowAggregate::SUM:
+            return OpMaker<OpWindowSum>::make(fold.sequence, firstStart,
+                                              windowSize, numberWindows);
+        case WindowAggregate::MIN:
+            return OpMaker<OpWindowMin>::make(fold.sequence, firstStart,
+                                              windowSize, numberWindows);
+        case WindowAggregate::MAX:
+            return OpMaker<OpWindowMax>::make(fold.sequence, firstStart,
+                                              windowSize, numberWindows);
+    }
+    shouldNotBeCalledPanic;
+}
+}  // namespace WindowAggregateDetail
+
+// rewrite [f(sum([s[j] | j : int(i + a..i + b)])) | i : int(l..u)], with l
+// and u constant, to [f(w) | w <- OpWindowSum(s)], likewise for min and max.
+// The windows are then slid over s instead of each being folded on its own.
+template <typename View>
+bool optimiseIfCanBeConvertedToWindowAggregate(Quantifier<View>&);
+template <>
+bool optimiseIfCanBeConvertedToWindowAggregate<SequenceView>(
+    Quantifier<SequenceView>& quant) {
+    using namespace WindowAggregateDetail;
+    auto intRangeTest = getAs<IntRange>(quant.container);
+    if (!intRangeTest || quant.condition || !intRangeTest->left->isConstant() ||
+        !intRangeTest->right->isConstant()) {
+        return false;
+    }
+    lib::optional<WindowFold> fold;
+    bool fail = false;
+    FindAndReplaceFunction foldFinder =
+        [&](AnyExprRef expr, const PathExtension&) -> pair<bool, AnyExprRef> {
+        auto intExprTest = lib::get_if<ExprRef<IntView>>(&expr);
+        if (!fail && intExprTest) {
+            auto foldTest = getIfWindowFold(quant.quantId, *intExprTest);
+            if (foldTest) {
+                fail = fold.has_value();
+                fold = foldTest;
+            }
+        }
+        return make_pair(false, expr);
+    };
+    lib::visit([&](auto& expr) { findAndReplace(expr, foldFinder); },
+               quant.expr);
+    if (fail || !fold) {
+        return false;
+    }
+    // the iterator may only be used by the bounds of the window.
+    size_t numberUses = 0;
+    auto tupleIndexCounter = filterForTupleIndexOverIterator(
+        quant.quantId, [&](auto& tupleIndex, const PathExtension&) {
+            numberUses += (tupleIndex.indexOperand == 1) ? 1 : 2;
+        });
+    FindAndReplaceFunction useCounter =
+        [&](AnyExprRef expr, const PathExtension path) {
+            auto containerTest = getQuantifierContainer(expr);
+            if (containerTest) {
+                lib::visit(
+                    [&](auto& container) {
+                        findAndReplace(container, useCounter);
+                    },
+                    *containerTest);
+            }
+            return tupleIndexCounter(move(expr), path);
+        };
+    lib::visit([&](auto& expr) { findAndReplace(expr, useCounter); },
+               quant.expr);
+    if (numberUses != 2) {
+        return false;
+    }
+    intRangeTest->left->evaluate();
+    intRangeTest->right->evaluate();
+    auto lowerView = intRangeTest->left->getViewIfDefined();
+    auto upperView = intRangeTest->right->getViewIfDefined();
+    if (!lowerView || !upperView || upperView->value < lowerView->value ||
+        lowerView->value + fold->lowOffset < 1) {
+        return false;
+    }
+    UInt firstStart = (lowerView->value + fold->lowOffset) - 1;
+    UInt numberWindows = (upperView->value - lowerView->value) + 1;
+    quant.container = makeWindowAggregate(*fold, firstStart, numberWindows);
+    auto newIterator = quant.newIterRef<TupleView>();
+    FindAndReplaceFunction replaceFunc =
+        [&](AnyExprRef expr, const PathExtension&) -> pair<bool, AnyExprRef> {
+        auto intExprTest = lib::get_if<ExprRef<IntView>>(&expr);
+        if (!intExprTest) {
+            return make_pair(false, expr);
+        }
+        auto foldTest = getIfWindowFold(quant.quantId, *intExprTest);
+        if (!foldTest || foldTest->foldOp != fold->foldOp) {
+            return make_pair(false, expr);
+        }
+        return make_pair(true, AnyExprRef(OpMaker<OpTupleIndex<IntView>>::make(
+                                   newIterator, 1)));
+    };
+    lib::visit([&](auto& expr) { expr = findAndReplace(expr, replaceFunc); },
+               quant.expr);
+    debug_log(
+        "Optimise: rewriting quantifier over windowed folds to window "
+        "aggregate.");
+    return true;
+}
+
 template <typename View>
 bool optimiseIfIndicesAreNotUsedInSequenceQuantifier(Quantifier<View>&) {
     return false;
@@ -22,6 +22,11 @@ struct ExprChangeTrigger
         return op->template getMembers<View>()[index];
     }
     void adapterValueChanged() {
+        if (op->foldingParent) {
+            op->template changeSubsequence<View>(index, index + 1);
+            op->foldingParent->unrolledExprChanged(index, this->foldedValue);
+            return;
+        }
         lib::visit(
             [&](auto& members) {
                 op->template changeSubsequenceAndNotify<viewType(members)>(
@@ -36,6 +41,7 @@ struct ExprChangeTrigger
                 triggerToChange));
         auto trigger =
             std::make_shared<ExprChangeTrigger<ContainerType, View>>(op, index);
+        trigger->foldedValue = triggerToChange->foldedValue;
         op->template getMembers<View>()[index]->addTrigger(trigger);
         triggerToChange = trigger;
     }
@@ -146,8 +146,8 @@ struct SimpleUnaryOperator : public View,
         bool = false);  // ignore bools, they are there to make it easier to
                         // compile between unary and binary ops
 
-    void startTriggeringImpl() final;
-    void stopTriggering() final;
+    void startTriggeringImpl() override;
+    void stopTriggering() override;
     ExprRef<View> deepCopyForUnrollImpl(const ExprRef<View>&,
                                         const AnyIterRef& iterator) const final;
     void findAndReplaceSelf(const FindAndReplaceFunction& func,
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 
 #include "operators/opSetLit.h"
 #include "parsing/parserCommon.h"
@@ -167,12 +168,87 @@ ParseResult parseOpAllDiff(json& operandExpr, ParsedModel& parsedModel) {
     ParseResult parsedOperandExpr =
         toSequence(parseExpr(operandExpr, parsedModel));
     auto sequence = lib::get<ExprRef<SequenceView>>(parsedOperandExpr.expr);
+    auto sequenceDomainTest =
+        lib::get_if<shared_ptr<SequenceDomain>>(&parsedOperandExpr.domain);
     bool constant = sequence->isConstant();
-    auto op = OpMaker<OpAllDiff>::make(sequence);
+    auto op = OpMaker<OpAllDiff>::make(
+        sequence, (sequenceDomainTest) ? *sequenceDomainTest : nullptr);
     op->setConstant(constant);
     return ParseResult(fakeBoolDomain, op, false);
 }
 
+// the members of a constant int matrix, in order.
+static vector<Int> parseConstantInts(json& intsExpr, ParsedModel& parsedModel,
+                                     const string& opName) {
+    ParseResult parsedIntsExpr = parseExpr(intsExpr, parsedModel);
+    bool constant = lib::visit([&](auto& expr) { return expr->isConstant(); },
+                               parsedIntsExpr.expr);
+    if (!constant) {
+        myCerr << "Error: " << opName
+               << " expects constant counts and values, but found: "
+               << intsExpr << endl;
+        myAbort();
+    }
+    auto ints = lib::get<ExprRef<SequenceView>>(
+        toSequence(move(parsedIntsExpr)).expr);
+    ints->evaluate();
+    vector<Int> values;
+    for (auto& member : ints->view()->getMembers<IntView>()) {
+        values.emplace_back(parseExprAsInt(member, "in " + opName));
+    }
+    return values;
+}
+
+// atmost, atleast and gcc.  Each value counted must occur between lower and
+// upper bound times in the operand, only one of the bounds is given for
+// atmost and atleast.
+static ParseResult parseGcc(json& operandExpr, json& valuesExpr,
+                            json& countsExpr, bool lowerBounded,
+                            bool upperBounded, ParsedModel& parsedModel,
+                            const string& opName) {
+    ParseResult parsedOperandExpr =
+        toSequence(parseExpr(operandExpr, parsedModel));
+    auto sequence = lib::get<ExprRef<SequenceView>>(parsedOperandExpr.expr);
+    auto values = parseConstantInts(valuesExpr, parsedModel, opName);
+    auto counts = parseConstantInts(countsExpr, parsedModel, opName);
+    if (values.size() != counts.size()) {
+        myCerr << "Error: " << opName
+               << " expects the same number of counts and values.\n";
+        myAbort();
+    }
+    vector<UInt> lowerBounds, upperBounds;
+    for (Int count : counts) {
+        if (count < 0) {
+            myCerr << "Error: " << opName
+                   << " does not support negative counts.\n";
+            myAbort();
+        }
+        lowerBounds.emplace_back((lowerBounded) ? count : 0);
+        upperBounds.emplace_back((upperBounded)
+                                     ? count
+                                     : numeric_limits<Int>::max());
+    }
+    bool constant = sequence->isConstant();
+    auto op = OpMaker<OpGcc>::make(sequence, values, lowerBounds, upperBounds);
+    op->setConstant(constant);
+    return ParseResult(fakeBoolDomain, op, false);
+}
+
+ParseResult parseOpAtMost(json& operandsExpr, ParsedModel& parsedModel) {
+    return parseGcc(operandsExpr[0], operandsExpr[2], operandsExpr[1], false,
+                    true, parsedModel, "atmost");
+}
+
+ParseResult parseOpAtLeast(json& operandsExpr, ParsedModel& parsedModel) {
+    return parseGcc(operandsExpr[0], operandsExpr[2], operandsExpr[1], true,
+                    false, parsedModel, "atleast");
+}
+
+ParseResult parseOpGcc(json& operandsExpr, ParsedModel& parsedModel) {
+    return parseGcc(operandsExpr[0], operandsExpr[1], operandsExpr[2], true,
+                    true, parsedModel, "gcc");
+}
+
 ParseResult parseOpEq(json& operandsExpr, ParsedModel& parsedModel) {
     AnyExprRef leftAnyExpr = parseExpr(operandsExpr[0], parsedModel).expr;
     AnyExprRef rightAnyExpr = parseExpr(operandsExpr[1], parsedModel).expr;
@@ -315,6 +391,57 @@ template ParseResult parseOpLess<true>(json&, ParsedModel&);
 template ParseResult parseOpLessEq<false>(json&, ParsedModel&);
 template ParseResult parseOpLessEq<true>(json&, ParsedModel&);
 
+// an operand of a lex comparison as a sequence of ints.  Tuples of ints
+// become a sequence literal of their members.
+static ExprRef<SequenceView> parseLexOperand(json& operandExpr,
+                                             ParsedModel& parsedModel) {
+    auto errorFunc = [&]() {
+        myCerr << "Error: lex comparisons expect matrices, sequences or "
+                  "tuples of ints.\n"
+               << operandExpr << endl;
+        myAbort();
+    };
+    ParseResult parsedOperandExpr = parseExpr(operandExpr, parsedModel);
+    auto tupleDomainTest =
+        lib::get_if<shared_ptr<TupleDomain>>(&parsedOperandExpr.domain);
+    if (tupleDomainTest) {
+        auto& tuple = lib::get<ExprRef<TupleView>>(parsedOperandExpr.expr);
+        auto& inners = (*tupleDomainTest)->inners;
+        ExprRefVec<IntView> members;
+        for (size_t i = 0; i < inners.size(); i++) {
+            if (!lib::get_if<shared_ptr<IntDomain>>(&inners[i])) {
+                errorFunc();
+            }
+            members.emplace_back(
+                OpMaker<OpTupleIndex<IntView>>::make(tuple, i));
+            members.back()->setConstant(tuple->isConstant());
+        }
+        auto sequence = OpMaker<OpSequenceLit>::make(move(members));
+        sequence->setConstant(tuple->isConstant());
+        return sequence;
+    }
+    ParseResult parsedSequenceExpr = toSequence(move(parsedOperandExpr));
+    auto sequenceDomainTest =
+        lib::get_if<shared_ptr<SequenceDomain>>(&parsedSequenceExpr.domain);
+    if (!sequenceDomainTest ||
+        !lib::get_if<shared_ptr<IntDomain>>(&(*sequenceDomainTest)->inner)) {
+        errorFunc();
+    }
+    return lib::get<ExprRef<SequenceView>>(parsedSequenceExpr.expr);
+}
+
+template <bool strict>
+ParseResult parseOpLex(json& expr, ParsedModel& parsedModel) {
+    auto left = parseLexOperand(expr[0], parsedModel);
+    auto right = parseLexOperand(expr[1], parsedModel);
+    auto op = OpMaker<OpLex<strict>>::make(left, right);
+    op->setConstant(left->isConstant() && right->isConstant());
+    return ParseResult(fakeBoolDomain, op, false);
+}
+
+template ParseResult parseOpLex<true>(json&, ParsedModel&);
+template ParseResult parseOpLex<false>(json&, ParsedModel&);
+
 ParseResult parseOpImplies(json& expr, ParsedModel& parsedModel) {
     auto errorFunc = [&](auto&&) {
         myCerr << "Expected bool within OpImplies less\n" << expr << endl;
@@ -110,16 +110,23 @@ ParseResult parseOpDiv(json& modExpr, ParsedModel& parsedModel) {
     return ParseResult(fakeIntDomain, op, false);
 }
 
+ParseResult parseOpSetDifference(ParseResult& left, ParseResult& right,
+                                 json& minusExpr);
 ParseResult parseOpMinus(json& minusExpr, ParsedModel& parsedModel) {
+    auto leftResult = parseExpr(minusExpr[0], parsedModel);
+    auto rightResult = parseExpr(minusExpr[1], parsedModel);
+    if (lib::get_if<shared_ptr<SetDomain>>(&leftResult.domain)) {
+        return parseOpSetDifference(leftResult, rightResult, minusExpr);
+    }
     string errorMessage =
         "Expected int returning expression within Op "
         "minus: ";
-    ExprRef<IntView> left = expect<IntView>(
-        parseExpr(minusExpr[0], parsedModel).expr,
-        [&](auto&&) { myCerr << errorMessage << minusExpr[0]; });
-    ExprRef<IntView> right = expect<IntView>(
-        parseExpr(minusExpr[1], parsedModel).expr,
-        [&](auto&&) { myCerr << errorMessage << minusExpr[1]; });
+    ExprRef<IntView> left = expect<IntView>(leftResult.expr, [&](auto&&) {
+        myCerr << errorMessage << minusExpr[0];
+    });
+    ExprRef<IntView> right = expect<IntView>(rightResult.expr, [&](auto&&) {
+        myCerr << errorMessage << minusExpr[1];
+    });
     bool constant = left->isConstant() && right->isConstant();
     auto op = OpMaker<OpMinus>::make(move(left), move(right));
     op->setConstant(constant);
@@ -219,3 +226,21 @@ ParseResult parseOpToInt(json& expr, ParsedModel& parsedModel) {
                        op, false);
     ;
 }
+
+ParseResult parseOpFreq(json& freqExpr, ParsedModel& parsedModel) {
+    auto mSetResult = parseExpr(freqExpr[0], parsedModel);
+    auto mSet = expect<MSetView>(mSetResult.expr, [&](auto&&) {
+        myCerr << "Expected mset returning expression as first argument to "
+                  "freq: "
+               << freqExpr[0] << endl;
+    });
+    AnyExprRef operand = parseExpr(freqExpr[1], parsedModel).expr;
+    return lib::visit(
+        [&](auto& operand) {
+            typedef viewType(operand) OperandView;
+            auto op = OpMaker<OpMSetFreq<OperandView>>::make(mSet, operand);
+            op->setConstant(mSet->isConstant() && operand->isConstant());
+            return ParseResult(fakeIntDomain, op, false);
+        },
+        operand);
+}
@@ -84,7 +84,11 @@ ParseResult bsetEq(json& subsetExpr, ParsedModel& parsedModel);
 ParseResult parseOpSubset(json& operandsExpr, ParsedModel& parsedModel);
 ParseResult parseOpSubsetEq(json& operandsExpr, ParsedModel& parsedModel);
 ParseResult parseOpIntersect(json& intersectExpr, ParsedModel& parsedModel);
+ParseResult parseOpUnion(json& unionExpr, ParsedModel& parsedModel);
 ParseResult parseOpAllDiff(json& operandExpr, ParsedModel& parsedModel);
+ParseResult parseOpAtMost(json& operandsExpr, ParsedModel& parsedModel);
+ParseResult parseOpAtLeast(json& operandsExpr, ParsedModel& parsedModel);
+ParseResult parseOpGcc(json& operandsExpr, ParsedModel& parsedModel);
 ParseResult parseOpPartitionParty(json& partsExpr, ParsedModel& parsedModel);
 ParseResult parseOpPartitionParts(json& partsExpr, ParsedModel& parsedModel);
 ParseResult parseOpPowerSet(json& powerSetExpr, ParsedModel& parsedModel);
@@ -109,10 +113,13 @@ ParseResult parseOpApart(json& operandsExpr, ParsedModel& parsedModel);
 template <bool>
 ParseResult parseOpLess(json& expr, ParsedModel& parsedModel);
 template <bool>
+ParseResult parseOpLex(json& expr, ParsedModel& parsedModel);
+template <bool>
 ParseResult parseOpLessEq(json& expr, ParsedModel& parsedModel);
 ParseResult parseOpImplies(json& expr, ParsedModel& parsedModel);
 ParseResult parseComprehension(json& comprExpr, ParsedModel& parsedModel);
 ParseResult parseOpToInt(json& expr, ParsedModel& parsedModel);
+ParseResult parseOpFreq(json& freqExpr, ParsedModel& parsedModel);
 // fudge
 
 ParseResult parseExpr(json& essenceExpr, ParsedModel& parsedModel) {
@@ -396,6 +403,8 @@ optional<ParseResult> tryParseExpr(json& essenceExpr,
              {"MkOpLeq", parseOpLessEq<false>},
              {"MkOpGt", parseOpLess<true>},
              {"MkOpGeq", parseOpLessEq<true>},
+             {"MkOpLexLt", parseOpLex<true>},
+             {"MkOpLexLeq", parseOpLex<false>},
              {"MkOpNeq", parseOpNotEq},
              {"MkOpImply", parseOpImplies},
              {"MkOpCatchUndef", parseOpCatchUndef},
@@ -412,9 +421,11 @@ optional<ParseResult> tryParseExpr(json& essenceExpr,
              {"MkOpMinus", parseOpMinus},
              {"MkOpPow", parseOpPower},
              {"MkOpIntersect", parseOpIntersect},
+             {"MkOpUnion", parseOpUnion},
              {"MkOpTogether", parseOpTogether},
              {"MkOpApart", parseOpApart},
              {"MkOpTwoBars", parseOpTwoBars},
+             {"MkOpFreq", parseOpFreq},
              {"MkOpPowerSet", parseOpPowerSet},
              {"MkOpSubsetEq", parseOpSubsetEq},
              {"MkOpSubset", parseOpSubset},
@@ -425,6 +436,9 @@ optional<ParseResult> tryParseExpr(json& essenceExpr,
              {"MkOpMin", parseSequenceFoldingOp<OpMin, IntView>},
              {"MkOpMax", parseSequenceFoldingOp<OpMax, IntView>},
              {"MkOpAllDiff", parseOpAllDiff},
+             {"MkOpAtMost", parseOpAtMost},
+             {"MkOpAtLeast", parseOpAtLeast},
+             {"MkOpGCC", parseOpGcc},
              {"MkOpRelationProj", parseOpRelationProj},
              {"MkOpIndexing", parseOpIndexing},
              {"MkOpParts", parseOpPartitionParts},
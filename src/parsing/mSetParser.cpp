@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 
 #include "parsing/parserCommon.h"
 #include "types/mSetVal.h"
@@ -28,3 +29,36 @@ ParseResult parseOpMSetLit(json& mSetExpr, ParsedModel& parsedModel) {
         make_shared<MSetDomain>(exactSize(numberElements), result.domain);
     return ParseResult(domain, mSet, result.hasEmptyType);
 }
+
+// called from parseOpUnion and parseOpIntersect once both operands are known
+// to be msets.
+template <bool isUnion>
+ParseResult parseOpMSetUnionIntersect(ParseResult& left, ParseResult& right) {
+    auto& leftDomain = lib::get<shared_ptr<MSetDomain>>(left.domain);
+    auto& rightDomain = lib::get<shared_ptr<MSetDomain>>(right.domain);
+    auto& innerDomain =
+        (left.hasEmptyType) ? rightDomain->inner : leftDomain->inner;
+    auto& leftMSet = lib::get<ExprRef<MSetView>>(left.expr);
+    auto& rightMSet = lib::get<ExprRef<MSetView>>(right.expr);
+    auto op = OpMaker<OpMSetUnionIntersect<isUnion>>::make(leftMSet, rightMSet);
+    op->setConstant(leftMSet->isConstant() && rightMSet->isConstant());
+    size_t leftMaxSize = leftDomain->sizeAttr.maxSize;
+    size_t rightMaxSize = rightDomain->sizeAttr.maxSize;
+    size_t maxSizeOfOp = min(leftMaxSize, rightMaxSize);
+    if (isUnion) {
+        maxSizeOfOp = (leftMaxSize < numeric_limits<size_t>::max() -
+                                         rightMaxSize)
+                          ? leftMaxSize + rightMaxSize
+                          : numeric_limits<size_t>::max();
+    }
+    bool hasEmptyType = (isUnion) ? left.hasEmptyType && right.hasEmptyType
+                                  : left.hasEmptyType || right.hasEmptyType;
+    return ParseResult(make_shared<MSetDomain>(maxSize(maxSizeOfOp),
+                                               innerDomain),
+                       op, hasEmptyType);
+}
+
+template ParseResult parseOpMSetUnionIntersect<true>(ParseResult&,
+                                                     ParseResult&);
+template ParseResult parseOpMSetUnionIntersect<false>(ParseResult&,
+                                                      ParseResult&);
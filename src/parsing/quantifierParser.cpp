@@ -226,7 +226,7 @@ template <typename Quantifier>
 void addConditionsToQuantifier(json& comprExpr, Quantifier& quantifier,
                                size_t generatorIndex,
                                ParsedModel& parsedModel) {
-    vector<ExprRef<BoolView>> conditions;
+    ExprRefVec<BoolView> conditions;
     for (size_t i = generatorIndex + 1; i < comprExpr[1].size(); i++) {
         auto& expr = comprExpr[1][i];
         if (!expr.count("Condition")) {
@@ -587,7 +587,7 @@ vector<shared_ptr<Quantifier<SetView>>> makeNestedQuantifiers(
 
         // add condition that we don't unroll any value that is unrolled
         // at a higher level
-        vector<ExprRef<BoolView>> notEqConditions;
+        ExprRefVec<BoolView> notEqConditions;
         for (size_t j = 0; j < i; j++) {
             notEqConditions.emplace_back(
                 OpMaker<OpNotEq<InnerViewType>>::make(iters[i], iters[j]));
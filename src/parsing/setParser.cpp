@@ -78,6 +78,8 @@ ParseResult parseOpSetLit(json& setExpr, ParsedModel& parsedModel) {
     return ParseResult(domain, set, result.hasEmptyType);
 }
 
+template <bool isUnion>
+ParseResult parseOpMSetUnionIntersect(ParseResult& left, ParseResult& right);
 ParseResult parseOpIntersect(json& intersectExpr, ParsedModel& parsedModel) {
     auto left = parseExpr(intersectExpr[0], parsedModel);
     auto right = parseExpr(intersectExpr[1], parsedModel);
@@ -95,14 +97,74 @@ ParseResult parseOpIntersect(json& intersectExpr, ParsedModel& parsedModel) {
                 return ParseResult(returnDomain, op,
                                    !left.hasEmptyType || !right.hasEmptyType);
             },
+            [&](shared_ptr<MSetDomain>&,
+                shared_ptr<MSetDomain>&) -> ParseResult {
+                return parseOpMSetUnionIntersect<false>(left, right);
+            },
             [&](auto&, auto&) -> ParseResult {
-                myCerr << "only supporting intersect for set.\n";
+                myCerr << "only supporting intersect for set and mset.\n";
                 myCerr << intersectExpr;
                 myAbort();
             }),
         left.domain, right.domain);
 }
 
+ParseResult parseOpUnion(json& unionExpr, ParsedModel& parsedModel) {
+    auto left = parseExpr(unionExpr[0], parsedModel);
+    auto right = parseExpr(unionExpr[1], parsedModel);
+    return mpark::visit(
+        overloaded(
+            [&](shared_ptr<SetDomain>& leftDomain,
+                shared_ptr<SetDomain>& rightDomain) -> ParseResult {
+                auto& innerDomain = (left.hasEmptyType) ? rightDomain->inner
+                                                        : leftDomain->inner;
+                auto& leftSet = mpark::get<ExprRef<SetView>>(left.expr);
+                auto& rightSet = mpark::get<ExprRef<SetView>>(right.expr);
+                auto op = OpMaker<OpSetUnion>::make(leftSet, rightSet);
+                op->setConstant(leftSet->isConstant() &&
+                                rightSet->isConstant());
+                size_t unionMaxSize = leftDomain->sizeAttr.maxSize;
+                if (unionMaxSize < numeric_limits<size_t>::max() -
+                                       rightDomain->sizeAttr.maxSize) {
+                    unionMaxSize += rightDomain->sizeAttr.maxSize;
+                } else {
+                    unionMaxSize = numeric_limits<size_t>::max();
+                }
+                return ParseResult(
+                    make_shared<SetDomain>(maxSize(unionMaxSize),
+                                           innerDomain),
+                    op, left.hasEmptyType && right.hasEmptyType);
+            },
+            [&](shared_ptr<MSetDomain>&,
+                shared_ptr<MSetDomain>&) -> ParseResult {
+                return parseOpMSetUnionIntersect<true>(left, right);
+            },
+            [&](auto&, auto&) -> ParseResult {
+                myCerr << "only supporting union for set and mset.\n";
+                myCerr << unionExpr;
+                myAbort();
+            }),
+        left.domain, right.domain);
+}
+
+// called from parseOpMinus once the left operand is known to be a set.
+ParseResult parseOpSetDifference(ParseResult& left, ParseResult& right,
+                                 json& minusExpr) {
+    auto& leftDomain = mpark::get<shared_ptr<SetDomain>>(left.domain);
+    auto leftSet = mpark::get<ExprRef<SetView>>(left.expr);
+    auto rightSet = expect<SetView>(right.expr, [&](auto&&) {
+        myCerr << "Expected set returning expression on the right of a set "
+                  "minus: "
+               << minusExpr[1];
+    });
+    auto op = OpMaker<OpSetDifference>::make(leftSet, rightSet);
+    op->setConstant(leftSet->isConstant() && rightSet->isConstant());
+    return ParseResult(
+        make_shared<SetDomain>(maxSize(leftDomain->sizeAttr.maxSize),
+                               leftDomain->inner),
+        op, left.hasEmptyType);
+}
+
 ParseResult parseOpFunctionRange(json& functionExpr, ParsedModel& parsedModel) {
     string errorMessage =
         "Expected function returning expression within Op "
@@ -0,0 +1,161 @@
+#include "search/commonSubexpressions.h"
+
+#include <initializer_list>
+
+#include "operators/opAbs.h"
+#include "operators/opAnd.h"
+#include "operators/opDiv.h"
+#include "operators/opFunctionImage.h"
+#include "operators/opImplies.h"
+#include "operators/opLess.h"
+#include "operators/opLessEq.h"
+#include "operators/opMSetSize.h"
+#include "operators/opMSetUnionIntersect.h"
+#include "operators/opMinMax.h"
+#include "operators/opMinus.h"
+#include "operators/opMod.h"
+#include "operators/opNegate.h"
+#include "operators/opNot.h"
+#include "operators/opNotEq.h"
+#include "operators/opOr.h"
+#include "operators/opPower.h"
+#include "operators/opProd.h"
+#include "operators/opSequenceIndex.h"
+#include "operators/opSequenceLit.h"
+#include "operators/opSequenceSize.h"
+#include "operators/opSetDifference.h"
+#include "operators/opSetIntersect.h"
+#include "operators/opSetSize.h"
+#include "operators/opSetUnion.h"
+#include "operators/opSubsetEq.h"
+#include "operators/opSum.h"
+#include "operators/opToInt.h"
+#include "operators/opTupleIndex.h"
+#include "operators/opTupleLit.h"
+#include "operators/quantifier.h"
+#include "types/allVals.h"
+#include "utils/hashUtils.h"
+#include "utils/ignoreUnused.h"
+using namespace std;
+
+namespace {
+template <typename... Ops, typename View>
+bool isAnyOf(const ExprRef<View>& expr) {
+    auto* exprPtr = &(*expr);
+    bool found = false;
+    ignoreUnused(initializer_list<int>{
+        (found |= dynamic_cast<const Ops*>(exprPtr) != nullptr, 0)...});
+    return found;
+}
+
+// true if the operator is determined by its type and operands, with any
+// further parameters appended to fields.  The fused operators, OpSum, OpAnd
+// and so on, only fuse with quantifiers, which are never shared, so a fused
+// quantifier keeps its single parent.
+template <typename View>
+bool isShareable(const ExprRef<View>& expr, vector<UInt64>& fields) {
+    if (isAnyOf<OpAbs, OpAnd, OpDiv, OpImplies, OpLess, OpLessEq, OpMSetSize,
+                OpMSetUnion, OpMSetIntersect, OpMin, OpMax, OpMinus, OpMod,
+                OpNegate, OpNot, OpNotEq<IntView>, OpNotEq<BoolView>,
+                OpNotEq<EnumView>, OpOr, OpPower, OpProd, OpSequenceSize,
+                OpSetDifference, OpSetIntersect, OpSetSize, OpSetUnion,
+                OpSubsetEq, OpSum, OpToInt, OpSequenceLit, OpTupleLit,
+                OpSequenceIndex<View>, OpFunctionImage<View>>(expr)) {
+        return true;
+    }
+    auto tupleIndexTest = getAs<OpTupleIndex<View>>(expr);
+    if (tupleIndexTest) {
+        fields.emplace_back(tupleIndexTest->indexOperand);
+        return true;
+    }
+    return false;
+}
+
+template <typename View>
+lib::optional<Int> getIfConstantValue(const ExprRef<View>&) {
+    return lib::nullopt;
+}
+
+template <>
+lib::optional<Int> getIfConstantValue<IntView>(const ExprRef<IntView>& expr) {
+    if (!expr->isConstant() || !dynamic_cast<const IntValue*>(&(*expr))) {
+        return lib::nullopt;
+    }
+    return expr->view()->value;
+}
+
+template <>
+lib::optional<Int> getIfConstantValue<BoolView>(
+    const ExprRef<BoolView>& expr) {
+    if (!expr->isConstant() || !dynamic_cast<const BoolValue*>(&(*expr))) {
+        return lib::nullopt;
+    }
+    return expr->view()->violation;
+}
+}  // namespace
+
+size_t SubexpressionSharer::KeyHash::operator()(const Key& key) const {
+    HashType fieldsHash =
+        mix((char*)key.fields.data(), key.fields.size() * sizeof(UInt64));
+    return hash<HashType>()(fieldsHash) ^ key.type.hash_code();
+}
+
+template <typename View>
+lib::optional<SubexpressionSharer::Key> SubexpressionSharer::makeKey(
+    ExprRef<View>& expr) {
+    auto constantValue = getIfConstantValue(expr);
+    if (constantValue) {
+        return Key{type_index(typeid(*expr)), {(UInt64)*constantValue}};
+    }
+    typedef typename AssociatedValueType<View>::type Value;
+    if (dynamic_cast<Value*>(&(*expr)) ||
+        dynamic_cast<QuantifierBase*>(&(*expr))) {
+        return lib::nullopt;
+    }
+    // share the operands first, so that identical operands are already the
+    // same node.
+    Key key{type_index(typeid(*expr)), {}};
+    FindAndReplaceFunction shareOperand =
+        [&](AnyExprRef operand,
+            const PathExtension&) -> pair<bool, AnyExprRef> {
+        AnyExprRef sharedOperand = lib::visit(
+            [&](auto& operand) -> AnyExprRef { return share(operand); },
+            operand);
+        lib::visit(
+            [&](auto& sharedOperand) {
+                key.fields.emplace_back((UInt64)(&(*sharedOperand)));
+            },
+            sharedOperand);
+        return make_pair(true, sharedOperand);
+    };
+    expr->findAndReplaceSelf(shareOperand, PathExtension::begin());
+    if (!isShareable(expr, key.fields)) {
+        return lib::nullopt;
+    }
+    return key;
+}
+
+template <typename View>
+ExprRef<View> SubexpressionSharer::share(ExprRef<View> expr) {
+    auto sharedTest = sharedNodes.find(&(*expr));
+    if (sharedTest != sharedNodes.end()) {
+        return lib::get<ExprRef<View>>(sharedTest->second);
+    }
+    ExprRef<View> sharedExpr = expr;
+    auto key = makeKey(expr);
+    if (key) {
+        auto insertion = nodesByKey.emplace(move(*key), expr);
+        if (!insertion.second) {
+            sharedExpr = lib::get<ExprRef<View>>(insertion.first->second);
+            ++numberShared;
+        }
+    }
+    sharedNodes.emplace(&(*expr), sharedExpr);
+    return sharedExpr;
+}
+
+#define shareInstantiators(name)                             \
+    template ExprRef<name##View> SubexpressionSharer::share( \
+        ExprRef<name##View>);
+buildForAllTypes(shareInstantiators, );
+#undef shareInstantiators
@@ -0,0 +1,43 @@
+#ifndef SRC_SEARCH_COMMONSUBEXPRESSIONS_H_
+#define SRC_SEARCH_COMMONSUBEXPRESSIONS_H_
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "base/base.h"
+
+// hash-conses expressions, structurally identical subexpressions are replaced
+// by one node which is then shared by all of their parents.  Expressions
+// support any number of parents, each adds its own trigger.  Must be run
+// after the last optimise pass, optimising a shared node copies it once per
+// parent.  Only operators whose value is determined by their type and
+// operands are shared.  Quantifiers are not entered, their bodies are
+// templates for unrolling.
+class SubexpressionSharer {
+    struct Key {
+        std::type_index type;
+        // the operands, as the addresses of their shared nodes, followed by
+        // any parameters of the operator.
+        std::vector<UInt64> fields;
+        inline bool operator==(const Key& other) const {
+            return type == other.type && fields == other.fields;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    // every node visited, mapped to the node that replaces it.
+    HashMap<const void*, AnyExprRef> sharedNodes;
+    std::unordered_map<Key, AnyExprRef, KeyHash> nodesByKey;
+
+    template <typename View>
+    lib::optional<Key> makeKey(ExprRef<View>& expr);
+
+   public:
+    // the number of nodes replaced by an identical node.
+    size_t numberShared = 0;
+    template <typename View>
+    ExprRef<View> share(ExprRef<View> expr);
+};
+
+#endif /* SRC_SEARCH_COMMONSUBEXPRESSIONS_H_ */
@@ -2,6 +2,7 @@
 
 #include <iostream>
 
+#include "search/commonSubexpressions.h"
 #include "search/endOfSearchException.h"
 #include "search/statsContainer.h"
 #ifdef WASM_TARGET
@@ -73,8 +74,60 @@ void addConstraintsOnVarsToBeSubstituted(ModelBuilder& builder, Model& model) {
     }
 }
 
+template <typename View>
+AnyExprRef makeConstantValue(ExprRef<View>&) {
+    shouldNotBeCalledPanic;
+}
+
+template <>
+AnyExprRef makeConstantValue<IntView>(ExprRef<IntView>& expr) {
+    auto val = make<IntValue>();
+    val->value = expr->view()->value;
+    val->setConstant(true);
+    return val.asExpr();
+}
+
+template <>
+AnyExprRef makeConstantValue<BoolView>(ExprRef<BoolView>& expr) {
+    auto val = make<BoolValue>();
+    val->violation = expr->view()->violation;
+    val->setConstant(true);
+    return val.asExpr();
+}
+
+// replace constant int and bool expressions, those depending only on
+// parameters, with their values, so that they are evaluated once here
+// rather than kept as operators.
+template <typename View>
+void foldConstants(ExprRef<View>& expr) {
+    FindAndReplaceFunction fold =
+        [&](AnyExprRef ref, const PathExtension&) -> pair<bool, AnyExprRef> {
+        return lib::visit(
+            [&](auto& subexpr) -> pair<bool, AnyExprRef> {
+                typedef viewType(subexpr) SubexprView;
+                typedef typename AssociatedValueType<SubexprView>::type Value;
+                bool foldable = is_same<SubexprView, IntView>::value ||
+                                is_same<SubexprView, BoolView>::value;
+                if (!foldable || !subexpr->isConstant() ||
+                    dynamic_cast<Value*>(&(*subexpr))) {
+                    return make_pair(false, ref);
+                }
+                subexpr->evaluate();
+                if (!subexpr->appearsDefined()) {
+                    return make_pair(true, ref);
+                }
+                debug_log("Optimise: folding constant "
+                          << subexpr->getOpName() << " to a value");
+                return make_pair(true, makeConstantValue(subexpr));
+            },
+            ref);
+    };
+    expr = findAndReplace(expr, fold);
+}
+
 template <typename View>
 void optimiseExpr(ExprRef<View>& expr) {
+    foldConstants(expr);
     while (::optimise(expr)) {
         // repeat until no more optimisations
     }
@@ -92,6 +145,20 @@ static void optimiseModel(ModelBuilder& builder, Model& model) {
                model.objective);
 }
 
+// share identical subexpressions between the constraints, the objective and
+// the expressions defining variables.
+static void shareCommonSubexpressions(Model& model) {
+    SubexpressionSharer sharer;
+    model.csp = sharer.share(model.csp);
+    lib::visit([&](auto& objective) { objective = sharer.share(objective); },
+               model.objective);
+    for (auto& nameExprPair : model.definingExpressions) {
+        lib::visit([&](auto& expr) { expr = sharer.share(expr); },
+                   nameExprPair.second);
+    }
+    debug_log("Shared " << sharer.numberShared << " common subexpressions.");
+}
+
 Model ModelBuilder::build() {
     clock_t startBuildTime = clock();
     addConstraintsOnVarsToBeSubstituted(*this, model);
@@ -112,6 +179,7 @@ Model ModelBuilder::build() {
     model.csp =
         make_shared<OpAnd>(make_shared<OpSequenceLit>(move(constraints)));
     optimiseExpr(model.csp);
+    shareCommonSubexpressions(model);
     createNeighbourhoods();
     createRandomReassignNeighbourhoods();
 
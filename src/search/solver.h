@@ -216,7 +216,7 @@ void search(std::shared_ptr<SearchStrategy>& searchStrategy, State& state) {
                 objective->startTriggering();
             },
             state.model.objective);
-        handleDefinedVarTriggers();
+        handleTriggersAfterPropagation();
     }
 
     if (runSanityChecks) {
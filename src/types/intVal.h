@@ -1,6 +1,7 @@
 
 #ifndef SRC_TYPES_INTVAL_H_
 #define SRC_TYPES_INTVAL_H_
+#include <algorithm>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -12,9 +13,13 @@ inline auto intBound(Int a, Int b) { return std::make_pair(a, b); }
 struct IntDomain {
     std::vector<std::pair<Int, Int>> bounds;
     UInt domainSize;
+    // the number of values in bounds[0] to bounds[i] inclusive, so that
+    // values can be found by index with a binary search.
+    std::vector<UInt> cumulativeSizes;
     IntDomain(std::vector<std::pair<Int, Int>> bounds)
         : bounds(normaliseBounds(std::move(bounds))),
-          domainSize(calculateDomainSize(this->bounds)) {}
+          domainSize(calculateDomainSize(this->bounds)),
+          cumulativeSizes(calculateCumulativeSizes(this->bounds)) {}
 
     inline std::shared_ptr<IntDomain> deepCopy(std::shared_ptr<IntDomain>&) {
         return std::make_shared<IntDomain>(*this);
@@ -28,19 +33,35 @@ struct IntDomain {
             });
     }
 
+    static inline std::vector<UInt> calculateCumulativeSizes(
+        const std::vector<std::pair<Int, Int>>& bounds) {
+        std::vector<UInt> sizes;
+        UInt total = 0;
+        for (auto& bound : bounds) {
+            total += (bound.second - bound.first) + 1;
+            sizes.emplace_back(total);
+        }
+        return sizes;
+    }
+
     // sort and unify overlaps
     static std::vector<std::pair<Int, Int>> normaliseBounds(
         std::vector<std::pair<Int, Int>> bounds) {
         std::sort(bounds.begin(), bounds.end());
-        std::remove_if(bounds.begin(), bounds.end(),
-                       [](auto& b) { return b.second < b.first; });
-        for (size_t i = 0; i < bounds.size() - 1; i++) {
-            // merge if overlap or forms contiguous domain
+        bounds.erase(std::remove_if(bounds.begin(), bounds.end(),
+                                    [](auto& b) { return b.second < b.first; }),
+                     bounds.end());
+        size_t i = 0;
+        while (i + 1 < bounds.size()) {
+            // merge if overlap or forms contiguous domain, the merged bound
+            // may reach the bound after.
             auto& bound = bounds[i];
             auto& nextBound = bounds[i + 1];
             if (bound.second >= nextBound.first - 1) {
                 bound.second = std::max(bound.second, nextBound.second);
                 bounds.erase(bounds.begin() + i + 1);
+            } else {
+                ++i;
             }
         }
         return bounds;
@@ -50,6 +71,20 @@ struct IntDomain {
         bounds.insert(bounds.end(), other.bounds.begin(), other.bounds.end());
         bounds = normaliseBounds(std::move(bounds));
         domainSize = calculateDomainSize(bounds);
+        cumulativeSizes = calculateCumulativeSizes(bounds);
+    }
+
+    // the value at zero based index in the sorted values of this domain, in
+    // O(log number bounds).
+    inline Int valueAtIndex(UInt index) const {
+        debug_code(assert(index < domainSize));
+        size_t boundIndex =
+            std::upper_bound(cumulativeSizes.begin(), cumulativeSizes.end(),
+                             index) -
+            cumulativeSizes.begin();
+        UInt offset =
+            (boundIndex == 0) ? index : index - cumulativeSizes[boundIndex - 1];
+        return bounds[boundIndex].first + offset;
     }
     // structs for possible return values of findContainingBound function below
     struct FoundBound {
@@ -80,21 +115,16 @@ struct IntDomain {
         if (value > bounds.back().second) {
             return OutOfBoundsLarge();
         }
-        for (size_t i = 0; i < bounds.size(); i++) {
-            const auto& bound = bounds[i];
-            if (bound.first <= value && bound.second >= value) {
-                return FoundBound(i);
-            }
-            if (i + 1 < bounds.size()) {
-                // has next bound
-                auto& nextBound = bounds[i + 1];
-                if (value > bound.second && value < nextBound.first) {
-                    return BetweenBounds(i, i + 1);
-                }
-            }
+        // the last bound starting at or before value.
+        size_t i = std::upper_bound(bounds.begin(), bounds.end(), value,
+                                    [](Int value, const auto& bound) {
+                                        return value < bound.first;
+                                    }) -
+                   bounds.begin() - 1;
+        if (value <= bounds[i].second) {
+            return FoundBound(i);
         }
-        // should never reach here
-        shouldNotBeCalledPanic;
+        return BetweenBounds(i, i + 1);
     }
 
     inline bool containsValue(Int value) const {
@@ -10,14 +10,15 @@ using namespace std;
 size_t numberElements(SequenceView& view) { return view.numberElements(); }
 template <>
 HashType getValueHash<SequenceView>(const SequenceView& val) {
-    return val.cachedHashTotal.getOrSet([&]() {
-        return lib::visit(
-            [&](auto& members) {
-                return val.calcSubsequenceHash<viewType(members)>(
-                    0, members.size());
-            },
-            val.members);
-    });
+    return val.cachedHashes
+        .getOrSet([&]() {
+            return lib::visit(
+                [&](auto& members) {
+                    return val.calcHashTree<viewType(members)>();
+                },
+                val.members);
+        })
+        .total();
 }
 
 template <>
@@ -70,7 +71,7 @@ template <typename InnerViewType>
 void deepCopyImpl(const SequenceValue&,
                   const ExprRefVec<InnerViewType>& srcMemnersImpl,
                   SequenceValue& target) {
-    target.cachedHashTotal.invalidate();
+    target.cachedHashes.invalidate();
     // to be optimised later
     target.silentClear();
     for (auto& member : srcMemnersImpl) {
@@ -240,27 +241,22 @@ void SequenceView::assertValidState() {
         [&](auto& valMembersImpl) {
             UInt numberUndefinedFound = 0;
             bool success = true;
-            HashType calculatedTotal(0);
             for (size_t i = 0; i < valMembersImpl.size(); i++) {
                 auto& member = valMembersImpl[i];
-                if (cachedHashTotal.isValid()) {
-                    auto view = member->getViewIfDefined();
-                    if (view) {
-                        calculatedTotal += this->calcMemberHash(i, member);
-                    }
-                }
                 if (!member->appearsDefined()) {
                     numberUndefinedFound++;
                 }
             }
             if (success) {
-                cachedHashTotal.applyIfValid([&](const auto& value) {
-                    success = (value == calculatedTotal);
+                cachedHashes.applyIfValid([&](const auto& hashes) {
+                    HashType calculatedTotal =
+                        this->calcHashTotal<viewType(valMembersImpl)>();
+                    success = (hashes.size() == valMembersImpl.size() &&
+                               hashes.total() == calculatedTotal);
                     if (!success) {
                         myCerr << "Calculated hash total should be "
                                << calculatedTotal << " but it was actually "
-                               << value << endl;
-                        ;
+                               << hashes.total() << endl;
                     }
                 });
             }
@@ -337,10 +333,10 @@ void SequenceView::standardSanityChecksForThisType() const {
                 sanityCheck(!this->appearsDefined(),
                             "operator should be undefined.");
             }
-            cachedHashTotal.applyIfValid([&](const auto& value) {
-                sanityEqualsCheck(
-                    calcSubsequenceHash<viewType(members)>(0, members.size()),
-                    value);
+            cachedHashes.applyIfValid([&](const auto& hashes) {
+                sanityEqualsCheck(members.size(), hashes.size());
+                sanityEqualsCheck(calcHashTotal<viewType(members)>(),
+                                  hashes.total());
             });
         },
         this->members);
@@ -7,6 +7,7 @@
 #include "triggers/sequenceTrigger.h"
 #include "utils/hashUtils.h"
 #include "utils/ignoreUnused.h"
+#include "utils/sequenceHashTree.h"
 #include "utils/simpleCache.h"
 
 // sequence calls getValueHash on ExprRef<T> so neeed to forward declare the
@@ -23,41 +24,51 @@ struct SequenceView : public ExprInterface<SequenceView>,
                       public TriggerContainer<SequenceView> {
     friend SequenceValue;
     AnyExprVec members;
-    SimpleCache<HashType> cachedHashTotal;
+    // member hashes, only maintained once the hash of this sequence has been
+    // requested.
+    SimpleCache<SequenceHashTree> cachedHashes;
     UInt numberUndefined = 0;
 
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
-    inline HashType calcMemberHash(UInt index,
-                                   const ExprRef<InnerViewType>& expr) const {
-        HashType input[2];
-        input[0] = HashType(index);
-        input[1] = getValueHash(
-            expr->view().checkedGet(NO_SEQUENCE_HASHING_UNDEFINED));
-        return mix(((char*)input), sizeof(input));
+    inline HashType calcMemberHash(const ExprRef<InnerViewType>& expr) const {
+        if (!expr->appearsDefined()) {
+            return HashType(0);
+        }
+        return mix(getValueHash(
+            expr->view().checkedGet(NO_SEQUENCE_HASHING_UNDEFINED)));
     }
 
+    // hash of the sequence calculated from scratch, agrees with
+    // SequenceHashTree::total()
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
-    inline HashType calcSubsequenceHash(UInt start, UInt end) const {
-        HashType total = HashType(0);
-        for (size_t i = start; i < end; ++i) {
-            total += calcMemberHash(i, getMembers<InnerViewType>()[i]);
+    inline HashType calcHashTotal() const {
+        auto& members = getMembers<InnerViewType>();
+        HashType total(0);
+        for (size_t i = members.size(); i > 0; --i) {
+            total = total * SequenceHashTree::base() +
+                    calcMemberHash(members[i - 1]);
         }
         return total;
     }
 
+    template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
+    inline SequenceHashTree calcHashTree() const {
+        SequenceHashTree hashes;
+        auto& members = getMembers<InnerViewType>();
+        for (size_t i = 0; i < members.size(); i++) {
+            hashes.insert(i, calcMemberHash(members[i]));
+        }
+        return hashes;
+    }
+
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
     inline void addMember(size_t index, const ExprRef<InnerViewType>& member) {
         auto& members = getMembers<InnerViewType>();
         members.insert(members.begin() + index, member);
-        bool memberUndefined = !member->appearsDefined();
-        if (!memberUndefined && index == members.size() - 1) {
-            cachedHashTotal.applyIfValid([&](auto& value) {
-                value += this->calcMemberHash(index, member);
-            });
-        } else {
-            cachedHashTotal.invalidate();
-        }
-        if (memberUndefined) {
+        cachedHashes.applyIfValid([&](auto& hashes) {
+            hashes.insert(index, this->calcMemberHash(member));
+        });
+        if (!member->appearsDefined()) {
             numberUndefined++;
             this->setAppearsDefined(false);
         }
@@ -70,13 +81,7 @@ struct SequenceView : public ExprInterface<SequenceView>,
         debug_code(assert(index < members.size()));
         ExprRef<InnerViewType> removedMember = std::move(members[index]);
         members.erase(members.begin() + index);
-        if (index == members.size()) {
-            cachedHashTotal.applyIfValid([&](auto& value) {
-                value -= this->calcMemberHash(index, removedMember);
-            });
-        } else {
-            cachedHashTotal.invalidate();
-        }
+        cachedHashes.applyIfValid([&](auto& hashes) { hashes.erase(index); });
         if (!removedMember->appearsDefined()) {
             numberUndefined--;
             if (numberUndefined == 0) {
@@ -91,60 +96,28 @@ struct SequenceView : public ExprInterface<SequenceView>,
     inline void swapPositions(UInt index1, UInt index2) {
         auto& members = getMembers<InnerViewType>();
         std::swap(members[index1], members[index2]);
-        cachedHashTotal.applyIfValid([&](auto& value) {
-            value -= this->calcMemberHash(index1, members[index2]);
-            value -= this->calcMemberHash(index2, members[index1]);
-            value += this->calcMemberHash(index1, members[index1]);
-            value += this->calcMemberHash(index2, members[index2]);
-        });
+        cachedHashes.applyIfValid(
+            [&](auto& hashes) { hashes.swap(index1, index2); });
         debug_code(assertValidState());
     }
 
-    inline void checkNotUsingCachedHash() {
-        if (cachedHashTotal.isValid()) {
-            myCerr
-                << "Error: constraint changing a subsequence without "
-                   "passing a previous subsequence hash.  Means no support for "
-                   "getting total hash of this sequence.  Suspected "
-                   "reason is that one of the constraints has not been "
-                   "updated to support this.\n";
-            myAbort();
-        }
-    }
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
     void replaceMember(UInt index, const ExprRef<InnerViewType>& newMember) {
         debug_code(assert(index < numberElements()));
-        if (cachedHashTotal.isValid()) {
-            cachedHashTotal.applyIfValid([&](auto& value) {
-                value -=
-                    this->calcSubsequenceHash<InnerViewType>(index, index + 1);
-                ;
-                getMembers<InnerViewType>()[index] = newMember;
-                value +=
-                    this->calcSubsequenceHash<InnerViewType>(index, index + 1);
-            });
-        } else {
-            getMembers<InnerViewType>()[index] = newMember;
-        }
-    }
-    template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
-    inline HashType changeSubsequence(UInt startIndex, UInt endIndex) {
-        checkNotUsingCachedHash();
-        return changeSubsequence<InnerViewType>(startIndex, endIndex,
-                                                HashType(0));
+        getMembers<InnerViewType>()[index] = newMember;
+        cachedHashes.applyIfValid([&](auto& hashes) {
+            hashes.set(index, this->calcMemberHash(newMember));
+        });
     }
 
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
-    inline HashType changeSubsequence(UInt startIndex, UInt endIndex,
-                                      HashType previousSubsequenceHash) {
-        HashType newHash = HashType(0);
-        cachedHashTotal.applyIfValid([&](auto& value) {
-            newHash =
-                this->calcSubsequenceHash<InnerViewType>(startIndex, endIndex);
-            value -= previousSubsequenceHash;
-            value += newHash;
+    inline void changeSubsequence(UInt startIndex, UInt endIndex) {
+        cachedHashes.applyIfValid([&](auto& hashes) {
+            auto& members = this->getMembers<InnerViewType>();
+            for (size_t i = startIndex; i < endIndex; i++) {
+                hashes.set(i, this->calcMemberHash(members[i]));
+            }
         });
-        return newHash;
     }
 
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
@@ -155,9 +128,9 @@ struct SequenceView : public ExprInterface<SequenceView>,
 
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
     inline void defineMemberAndNotify(UInt index) {
-        cachedHashTotal.applyIfValid([&](auto& value) {
-            value +=
-                this->calcMemberHash(index, getMembers<InnerViewType>()[index]);
+        cachedHashes.applyIfValid([&](auto& hashes) {
+            hashes.set(index, this->calcMemberHash(
+                                  this->getMembers<InnerViewType>()[index]));
         });
         debug_code(assert(numberUndefined > 0));
         numberUndefined--;
@@ -169,14 +142,8 @@ struct SequenceView : public ExprInterface<SequenceView>,
 
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
     inline void undefineMemberAndNotify(UInt index) {
-        checkNotUsingCachedHash();
-        undefineMemberAndNotify<InnerViewType>(index, HashType(0));
-    }
-    template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
-    inline void undefineMemberAndNotify(UInt index,
-                                        HashType hashOfPossibleChange) {
-        cachedHashTotal.applyIfValid(
-            [&](auto& value) { value -= hashOfPossibleChange; });
+        cachedHashes.applyIfValid(
+            [&](auto& hashes) { hashes.set(index, HashType(0)); });
         numberUndefined++;
         this->setAppearsDefined(false);
         notifyMemberUndefined(index);
@@ -185,7 +152,7 @@ struct SequenceView : public ExprInterface<SequenceView>,
     void silentClear() {
         lib::visit(
             [&](auto& membersImpl) {
-                cachedHashTotal.invalidate();
+                cachedHashes.invalidate();
                 membersImpl.clear();
             },
             members);
@@ -210,18 +177,6 @@ struct SequenceView : public ExprInterface<SequenceView>,
         return removedValue;
     }
 
-    template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
-    inline HashType notifyPossibleSubsequenceChange(UInt startIndex,
-                                                    UInt endIndex) {
-        debug_code(assertValidState());
-        HashType previousSubSequenceHash = HashType(0);
-        if (cachedHashTotal.isValid()) {
-            previousSubSequenceHash =
-                calcSubsequenceHash<InnerViewType>(startIndex, endIndex);
-        }
-        return previousSubSequenceHash;
-    }
-
     template <typename InnerViewType, EnableIfView<InnerViewType> = 0>
     void replaceMemberAndNotify(UInt index,
                                 const ExprRef<InnerViewType>& newMember) {
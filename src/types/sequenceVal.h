@@ -187,7 +187,7 @@ struct SequenceValue : public SequenceView, public ValBase {
     }
 
     template <typename InnerValueType, EnableIfValue<InnerValueType> = 0>
-    inline HashType notifyPossibleSubsequenceChange(
+    inline void notifyPossibleSubsequenceChange(
         UInt start, UInt end, std::vector<HashType>& hashOfMembersToBeChanged) {
         typedef typename AssociatedViewType<InnerValueType>::type InnerViewType;
         hashOfMembersToBeChanged.clear();
@@ -196,18 +196,13 @@ struct SequenceValue : public SequenceView, public ValBase {
             hashOfMembersToBeChanged.emplace_back(
                 getValueHash(members[i]->view().get()));
         }
-        return SequenceView::notifyPossibleSubsequenceChange<InnerViewType>(
-            start, end);
     }
 
     template <typename InnerValueType, EnableIfValue<InnerValueType> = 0>
-    inline HashType changeSubsequence(
-        UInt start, UInt end, std::vector<HashType>& hashOfMembersToBeChanged,
-        HashType previousSubsequenceHash) {
+    inline void changeSubsequence(
+        UInt start, UInt end, std::vector<HashType>& hashOfMembersToBeChanged) {
         typedef typename AssociatedViewType<InnerValueType>::type InnerViewType;
-        HashType newHashOfPossibleChange =
-            SequenceView::changeSubsequence<InnerViewType>(
-                start, end, previousSubsequenceHash);
+        SequenceView::changeSubsequence<InnerViewType>(start, end);
         for (HashType hash : hashOfMembersToBeChanged) {
             memberHashes.erase(hash);
         }
@@ -218,7 +213,6 @@ struct SequenceValue : public SequenceView, public ValBase {
                 getValueHash(members[i]->view()));
             memberHashes.insert(hashOfMembersToBeChanged.back());
         }
-        return newHashOfPossibleChange;
     }
 
     template <typename InnerValueType, typename Func,
@@ -243,14 +237,15 @@ struct SequenceValue : public SequenceView, public ValBase {
               EnableIfValue<InnerValueType> = 0>
     inline bool trySubsequenceChange(UInt start, UInt end,
                                      const std::vector<HashType>& hashes,
-                                     HashType previousSubsequenceHash,
                                      Func&& func) {
         typedef typename AssociatedViewType<InnerValueType>::type InnerViewType;
-        HashType cachedHashTotalBackup = HashType(0);
-        cachedHashTotal.applyIfValid(
-            [&](auto& v) { cachedHashTotalBackup = v; });
-        SequenceView::changeSubsequence<InnerViewType>(start, end,
-                                                       previousSubsequenceHash);
+        std::vector<HashType> previousMemberHashes;
+        cachedHashes.applyIfValid([&](auto& cachedHashes) {
+            for (size_t i = start; i < end; i++) {
+                previousMemberHashes.emplace_back(cachedHashes.get(i));
+            }
+        });
+        SequenceView::changeSubsequence<InnerViewType>(start, end);
         if (func()) {
             if (injective) {
                 for (HashType hash : hashes) {
@@ -265,10 +260,12 @@ struct SequenceValue : public SequenceView, public ValBase {
             SequenceView::notifySubsequenceChanged(start, end);
             return true;
         } else {
-            cachedHashTotal.applyIfValid(
-                [&](auto& v) { v = cachedHashTotalBackup; });
+            cachedHashes.applyIfValid([&](auto& cachedHashes) {
+                for (size_t i = start; i < end; i++) {
+                    cachedHashes.set(i, previousMemberHashes[i - start]);
+                }
+            });
             return false;
-            ;
         }
     }
 
@@ -29,6 +29,10 @@ HashType HashType::operator*(size_t repeatAmount) const {
     return HashType(value * repeatAmount);
 }
 
+HashType HashType::operator*(const HashType other) const {
+    return HashType(value * other.value);
+}
+
 HashType operator*(size_t repeatAmount, HashType hash) {
     return hash * repeatAmount;
 }
@@ -24,6 +24,7 @@ class HashType {
     HashType& operator+=(const HashType other);
     HashType& operator-=(const HashType other);
     HashType operator*(size_t repeatAmount) const;
+    HashType operator*(const HashType other) const;
     friend HashType operator*(size_t repeatAmount, HashType hash);
     bool operator==(const HashType& other) const;
     bool operator!=(const HashType& other) const;
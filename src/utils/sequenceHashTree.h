@@ -0,0 +1,198 @@
+#ifndef SRC_UTILS_SEQUENCEHASHTREE_H_
+#define SRC_UTILS_SEQUENCEHASHTREE_H_
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/intSize.h"
+#include "common/common.h"
+#include "utils/hashUtils.h"
+
+/* Positional hash of a list of member hashes:
+ * total() == h_0 + h_1 * base() + h_2 * base()^2 + ... (modulo 2^64).
+ * Members are stored in an implicit treap, each node caching the hash of its
+ * subtree and base()^(subtree size).  Inserting or erasing at any position
+ * implicitly shifts the members that follow by one place, so the total can be
+ * maintained in O(log n) without revisiting the shifted members.*/
+class SequenceHashTree {
+   public:
+    static inline HashType base() { return HashType(0x9e3779b97f4a7c15ull); }
+
+   private:
+    struct Node {
+        HashType memberHash;
+        HashType subtreeHash;
+        HashType power;
+        std::uint32_t size;
+        std::uint32_t priority;
+        std::int32_t left = -1;
+        std::int32_t right = -1;
+    };
+    std::vector<Node> nodes;
+    std::vector<std::int32_t> freeNodes;
+    std::int32_t root = -1;
+    // priorities are drawn from a private generator so that maintaining
+    // hashes does not disturb the search's random number stream.
+    std::uint64_t randomState = 88172645463325252ull;
+
+    inline std::uint32_t nextPriority() {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 7;
+        randomState ^= randomState << 17;
+        return randomState >> 32;
+    }
+    inline std::uint32_t sizeOf(std::int32_t node) const {
+        return (node < 0) ? 0 : nodes[node].size;
+    }
+    inline HashType powerOf(std::int32_t node) const {
+        return (node < 0) ? HashType(1) : nodes[node].power;
+    }
+    inline HashType hashOf(std::int32_t node) const {
+        return (node < 0) ? HashType(0) : nodes[node].subtreeHash;
+    }
+
+    inline void update(std::int32_t node) {
+        Node& n = nodes[node];
+        HashType leftPower = powerOf(n.left);
+        n.size = sizeOf(n.left) + 1 + sizeOf(n.right);
+        n.power = leftPower * base() * powerOf(n.right);
+        n.subtreeHash = hashOf(n.left) + n.memberHash * leftPower +
+                        hashOf(n.right) * (leftPower * base());
+    }
+
+    std::int32_t merge(std::int32_t left, std::int32_t right) {
+        if (left < 0) {
+            return right;
+        }
+        if (right < 0) {
+            return left;
+        }
+        if (nodes[left].priority > nodes[right].priority) {
+            nodes[left].right = merge(nodes[left].right, right);
+            update(left);
+            return left;
+        } else {
+            nodes[right].left = merge(left, nodes[right].left);
+            update(right);
+            return right;
+        }
+    }
+
+    // split the first numberToSplit members of node into left, the rest into
+    // right.
+    void split(std::int32_t node, std::uint32_t numberToSplit,
+               std::int32_t& left, std::int32_t& right) {
+        if (node < 0) {
+            left = right = -1;
+            return;
+        }
+        if (sizeOf(nodes[node].left) >= numberToSplit) {
+            std::int32_t leftOfLeft;
+            split(nodes[node].left, numberToSplit, leftOfLeft,
+                  nodes[node].left);
+            right = node;
+            left = leftOfLeft;
+        } else {
+            std::int32_t rightOfRight;
+            split(nodes[node].right,
+                  numberToSplit - sizeOf(nodes[node].left) - 1,
+                  nodes[node].right, rightOfRight);
+            left = node;
+            right = rightOfRight;
+        }
+        update(node);
+    }
+
+    std::int32_t newNode(HashType memberHash) {
+        std::int32_t node;
+        if (!freeNodes.empty()) {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            node = nodes.size();
+            nodes.emplace_back();
+        }
+        Node& n = nodes[node];
+        n.memberHash = memberHash;
+        n.priority = nextPriority();
+        n.left = n.right = -1;
+        update(node);
+        return node;
+    }
+
+    std::int32_t find(std::uint32_t index) const {
+        std::int32_t node = root;
+        while (true) {
+            debug_code(assert(node >= 0));
+            std::uint32_t leftSize = sizeOf(nodes[node].left);
+            if (index < leftSize) {
+                node = nodes[node].left;
+            } else if (index == leftSize) {
+                return node;
+            } else {
+                index -= leftSize + 1;
+                node = nodes[node].right;
+            }
+        }
+    }
+
+    void setImpl(std::int32_t node, std::uint32_t index,
+                 HashType memberHash) {
+        std::uint32_t leftSize = sizeOf(nodes[node].left);
+        if (index < leftSize) {
+            setImpl(nodes[node].left, index, memberHash);
+        } else if (index == leftSize) {
+            nodes[node].memberHash = memberHash;
+        } else {
+            setImpl(nodes[node].right, index - leftSize - 1, memberHash);
+        }
+        update(node);
+    }
+
+   public:
+    inline size_t size() const { return sizeOf(root); }
+    inline HashType total() const { return hashOf(root); }
+
+    void insert(size_t index, HashType memberHash) {
+        debug_code(assert(index <= size()));
+        std::int32_t node = newNode(memberHash);
+        std::int32_t left, right;
+        split(root, index, left, right);
+        root = merge(merge(left, node), right);
+    }
+
+    HashType erase(size_t index) {
+        debug_code(assert(index < size()));
+        std::int32_t left, middle, right;
+        split(root, index, left, right);
+        split(right, 1, middle, right);
+        HashType memberHash = nodes[middle].memberHash;
+        freeNodes.emplace_back(middle);
+        root = merge(left, right);
+        return memberHash;
+    }
+
+    inline HashType get(size_t index) const {
+        debug_code(assert(index < size()));
+        return nodes[find(index)].memberHash;
+    }
+
+    inline void set(size_t index, HashType memberHash) {
+        debug_code(assert(index < size()));
+        setImpl(root, index, memberHash);
+    }
+
+    inline void swap(size_t index1, size_t index2) {
+        HashType hash1 = get(index1);
+        set(index1, get(index2));
+        set(index2, hash1);
+    }
+
+    void clear() {
+        nodes.clear();
+        freeNodes.clear();
+        root = -1;
+    }
+};
+
+#endif /* SRC_UTILS_SEQUENCEHASHTREE_H_ */
@@ -0,0 +1,338 @@
+#ifndef SRC_UTILS_SMALLVECTOR_H_
+#define SRC_UTILS_SMALLVECTOR_H_
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "common/common.h"
+
+/* A vector that stores up to InlineCapacity elements inside the object itself
+ * and only moves to a heap buffer once it grows beyond that.  Used for the
+ * member vectors of expressions (ExprRefVec), most of which are small, to
+ * save an allocation and a pointer chase per node.  Offers the subset of the
+ * std::vector interface used in this code base; iterators are raw pointers.
+ * Note that unlike std::vector, moving a SmallVector that is using its inline
+ * storage moves the elements, invalidating references to them.*/
+template <typename T, size_t InlineCapacity>
+class SmallVector {
+    T* start;
+    size_t numberElements = 0;
+    size_t allocatedCapacity = InlineCapacity;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type
+        inlineStorage[InlineCapacity];
+
+    inline T* inlineBuffer() { return reinterpret_cast<T*>(inlineStorage); }
+    inline bool usingInlineStorage() const {
+        return start == reinterpret_cast<const T*>(inlineStorage);
+    }
+
+    void growTo(size_t newCapacity) {
+        T* newStart =
+            static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+        std::uninitialized_copy(std::make_move_iterator(start),
+                                std::make_move_iterator(start + numberElements),
+                                newStart);
+        destroyRange(start, start + numberElements);
+        releaseHeapBuffer();
+        start = newStart;
+        allocatedCapacity = newCapacity;
+    }
+    inline void growForOneMore() {
+        if (numberElements == allocatedCapacity) {
+            growTo(allocatedCapacity * 2);
+        }
+    }
+
+    static inline void destroyRange(T* first, T* last) {
+        for (; first != last; ++first) {
+            first->~T();
+        }
+    }
+    inline void releaseHeapBuffer() {
+        if (!usingInlineStorage()) {
+            ::operator delete(start);
+        }
+    }
+
+    // take the elements of other, leaving other empty.
+    void stealFrom(SmallVector& other) {
+        if (other.usingInlineStorage()) {
+            start = inlineBuffer();
+            allocatedCapacity = InlineCapacity;
+            std::uninitialized_copy(
+                std::make_move_iterator(other.start),
+                std::make_move_iterator(other.start + other.numberElements),
+                start);
+            numberElements = other.numberElements;
+            other.clear();
+        } else {
+            start = other.start;
+            numberElements = other.numberElements;
+            allocatedCapacity = other.allocatedCapacity;
+            other.start = other.inlineBuffer();
+            other.numberElements = 0;
+            other.allocatedCapacity = InlineCapacity;
+        }
+    }
+
+    // open a gap of count uninitialised slots at index, returns pointer to
+    // the gap
+    T* openGap(size_t index, size_t count) {
+        if (numberElements + count > allocatedCapacity) {
+            growTo(std::max(allocatedCapacity * 2, numberElements + count));
+        }
+        T* gap = start + index;
+        T* oldEnd = start + numberElements;
+        size_t numberToShift = numberElements - index;
+        if (numberToShift > 0) {
+            // move construct into the uninitialised tail, move assign the
+            // rest backwards, then destroy the vacated gap
+            size_t numberIntoRaw = std::min(numberToShift, count);
+            std::uninitialized_copy(
+                std::make_move_iterator(oldEnd - numberIntoRaw),
+                std::make_move_iterator(oldEnd),
+                oldEnd + count - numberIntoRaw);
+            std::move_backward(gap, oldEnd - numberIntoRaw,
+                               oldEnd + count - numberIntoRaw);
+            destroyRange(gap, gap + std::min(numberToShift, count));
+        }
+        numberElements += count;
+        return gap;
+    }
+
+   public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    SmallVector() : start(inlineBuffer()) {}
+    explicit SmallVector(size_t count) : SmallVector() { resize(count); }
+    SmallVector(size_t count, const T& value) : SmallVector() {
+        resize(count, value);
+    }
+    SmallVector(std::initializer_list<T> values) : SmallVector() {
+        insert(end(), values.begin(), values.end());
+    }
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::value_type>
+    SmallVector(InputIt first, InputIt last) : SmallVector() {
+        insert(end(), first, last);
+    }
+    SmallVector(const SmallVector& other) : SmallVector() {
+        insert(end(), other.begin(), other.end());
+    }
+    SmallVector(SmallVector&& other) noexcept : SmallVector() {
+        stealFrom(other);
+    }
+    ~SmallVector() {
+        destroyRange(start, start + numberElements);
+        releaseHeapBuffer();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            insert(end(), other.begin(), other.end());
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            releaseHeapBuffer();
+            stealFrom(other);
+        }
+        return *this;
+    }
+    SmallVector& operator=(std::initializer_list<T> values) {
+        clear();
+        insert(end(), values.begin(), values.end());
+        return *this;
+    }
+
+    inline iterator begin() { return start; }
+    inline iterator end() { return start + numberElements; }
+    inline const_iterator begin() const { return start; }
+    inline const_iterator end() const { return start + numberElements; }
+    inline const_iterator cbegin() const { return start; }
+    inline const_iterator cend() const { return start + numberElements; }
+    inline reverse_iterator rbegin() { return reverse_iterator(end()); }
+    inline reverse_iterator rend() { return reverse_iterator(begin()); }
+    inline const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    inline const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    inline size_t size() const { return numberElements; }
+    inline bool empty() const { return numberElements == 0; }
+    inline size_t capacity() const { return allocatedCapacity; }
+    inline T* data() { return start; }
+    inline const T* data() const { return start; }
+
+    inline T& operator[](size_t index) {
+        debug_code(assert(index < numberElements));
+        return start[index];
+    }
+    inline const T& operator[](size_t index) const {
+        debug_code(assert(index < numberElements));
+        return start[index];
+    }
+    T& at(size_t index) {
+        if (index >= numberElements) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return start[index];
+    }
+    const T& at(size_t index) const {
+        if (index >= numberElements) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return start[index];
+    }
+    inline T& front() { return start[0]; }
+    inline const T& front() const { return start[0]; }
+    inline T& back() { return start[numberElements - 1]; }
+    inline const T& back() const { return start[numberElements - 1]; }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > allocatedCapacity) {
+            growTo(newCapacity);
+        }
+    }
+    void clear() {
+        destroyRange(start, start + numberElements);
+        numberElements = 0;
+    }
+    void resize(size_t newSize) {
+        if (newSize < numberElements) {
+            destroyRange(start + newSize, start + numberElements);
+        } else {
+            reserve(newSize);
+            for (T* i = start + numberElements; i != start + newSize; ++i) {
+                new (i) T();
+            }
+        }
+        numberElements = newSize;
+    }
+    void resize(size_t newSize, const T& value) {
+        if (newSize < numberElements) {
+            destroyRange(start + newSize, start + numberElements);
+            numberElements = newSize;
+        } else {
+            insert(end(), newSize - numberElements, value);
+        }
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (numberElements == allocatedCapacity) {
+            // args may refer to a member of this vector
+            T value(std::forward<Args>(args)...);
+            growForOneMore();
+            new (start + numberElements) T(std::move(value));
+        } else {
+            new (start + numberElements) T(std::forward<Args>(args)...);
+        }
+        return start[numberElements++];
+    }
+    inline void push_back(const T& value) { emplace_back(value); }
+    inline void push_back(T&& value) { emplace_back(std::move(value)); }
+    inline void pop_back() {
+        debug_code(assert(numberElements > 0));
+        start[--numberElements].~T();
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_t index = pos - start;
+        T value(std::forward<Args>(args)...);
+        T* gap = openGap(index, 1);
+        new (gap) T(std::move(value));
+        return gap;
+    }
+    inline iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
+    inline iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_t count, const T& value) {
+        size_t index = pos - start;
+        T copy(value);
+        T* gap = openGap(index, count);
+        std::uninitialized_fill(gap, gap + count, copy);
+        return gap;
+    }
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::value_type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        size_t index = pos - start;
+        size_t count = std::distance(first, last);
+        if (count == 0) {
+            return start + index;
+        }
+        if (index == numberElements) {
+            reserve(numberElements + count);
+            std::uninitialized_copy(first, last, start + numberElements);
+            numberElements += count;
+            return start + index;
+        }
+        // copy first in case the range is part of this vector
+        SmallVector<T, InlineCapacity> values(first, last);
+        T* gap = openGap(index, count);
+        std::uninitialized_copy(std::make_move_iterator(values.begin()),
+                                std::make_move_iterator(values.end()), gap);
+        return gap;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<T> values) {
+        return insert(pos, values.begin(), values.end());
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        T* firstToErase = start + (first - start);
+        T* lastToErase = start + (last - start);
+        if (firstToErase != lastToErase) {
+            T* newEnd = std::move(lastToErase, end(), firstToErase);
+            destroyRange(newEnd, end());
+            numberElements = newEnd - start;
+        }
+        return firstToErase;
+    }
+
+    void swap(SmallVector& other) {
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+    friend inline void swap(SmallVector& a, SmallVector& b) { a.swap(b); }
+
+    inline bool operator==(const SmallVector& other) const {
+        return size() == other.size() &&
+               std::equal(begin(), end(), other.begin());
+    }
+    inline bool operator!=(const SmallVector& other) const {
+        return !(*this == other);
+    }
+    friend inline std::ostream& operator<<(std::ostream& os,
+                                           const SmallVector& iterable) {
+        return containerToArrayString(os, iterable);
+    }
+};
+
+#endif /* SRC_UTILS_SMALLVECTOR_H_ */